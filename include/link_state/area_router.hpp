@@ -0,0 +1,338 @@
+/*
+ *
+ * Copyright Niels Post 2019.
+ * Distributed under the Boost Software License, Version 1.0.
+ * (See accompanying file LICENSE_1_0.txt or copy at
+ * https://www.boost.org/LICENSE_1_0.txt)
+ *
+*/
+
+#ifndef IPASS_LINK_STATE_AREA_ROUTER_HPP
+#define IPASS_LINK_STATE_AREA_ROUTER_HPP
+
+#include <utility>
+#include <link_state/calculator.hpp>
+
+namespace link_state {
+
+    /**
+     * \addtogroup link_state
+     * @{
+     */
+
+    /**
+     * \brief Hierarchical (area based) routing on top of one calculator per area.
+     *
+     * Every area this router is attached to has its own calculator, holding only the nodes inside that area, with this router as source.
+     * Destinations outside the attached areas are learned through summaries: area border routers advertise the distance from themselves to each destination.
+     * The route to such a destination goes through the border router with the lowest (distance to border + summary cost).
+     *
+     * Changes inside an area only mark that area as changed, update() then only recalculates changed areas,
+     * after which the inter-area routes are recalculated from the summaries, which doesn't need any shortest path runs.
+     * Intra-area routes are always preferred over inter-area routes.
+     * @tparam calculator_type Calculator type used for each area
+     * @tparam max_areas Maximum number of attached areas
+     * @tparam max_summaries Maximum number of summaries (and inter-area destinations)
+     */
+    template<typename calculator_type, size_t max_areas, size_t max_summaries>
+    class area_router {
+    public:
+        using id_type = typename calculator_type::id_t;
+        using cost_type = typename calculator_type::cost_t;
+        using node_type = typename calculator_type::node_type;
+        using algebra = typename calculator_type::algebra_type;
+
+        /**
+         * \brief Summary of a destination outside an area, as advertised by a border router of that area.
+         */
+        struct summary {
+            /// Area the summary was received in
+            size_t area;
+            /// Border router advertising the summary
+            id_type border;
+            /// Destination outside the area
+            id_type destination;
+            /// Distance from the border router to the destination
+            cost_type cost;
+        };
+
+    private:
+        /**
+         * \brief Best known inter-area route to a destination.
+         */
+        struct inter_area_route {
+            id_type destination;
+            size_t area;
+            id_type border;
+            cost_type distance;
+        };
+
+        std::array<calculator_type, max_areas> areas;
+        std::array<bool, max_areas> changed = {};
+        size_t area_count = 0;
+
+        std::array<summary, max_summaries> summaries = {};
+        size_t summary_count = 0;
+        bool summaries_changed = false;
+
+        std::array<inter_area_route, max_summaries> routes = {};
+        size_t route_count = 0;
+
+        template<size_t... indices>
+        static std::array<calculator_type, max_areas>
+        make_areas(const id_type &router_id, std::index_sequence<indices...>) {
+            return {{((void) indices, calculator_type(router_id))...}};
+        }
+
+        size_t find_summary(const size_t &area, const id_type &border, const id_type &destination) const {
+            for (size_t i = 0; i < summary_count; i++) {
+                if (summaries[i].area == area && summaries[i].border == border &&
+                    summaries[i].destination == destination) {
+                    return i;
+                }
+            }
+            return summary_count;
+        }
+
+        size_t find_route(const id_type &destination) const {
+            for (size_t i = 0; i < route_count; i++) {
+                if (routes[i].destination == destination) {
+                    return i;
+                }
+            }
+            return route_count;
+        }
+
+        size_t find_intra_area(const id_type &destination) {
+            size_t best_area = area_count;
+            for (size_t area = 0; area < area_count; area++) {
+                size_t index = areas[area].get_index_by_id(destination);
+                if (index == areas[area].get_node_count() || !areas[area].get_node(index).shortest_path_known) {
+                    continue;
+                }
+                if (best_area == area_count ||
+                    algebra::better(areas[area].get_node(index).distance, get_intra_distance(best_area, destination))) {
+                    best_area = area;
+                }
+            }
+            return best_area;
+        }
+
+        cost_type get_intra_distance(const size_t &area, const id_type &destination) {
+            size_t index = areas[area].get_index_by_id(destination);
+            if (index == areas[area].get_node_count() || !areas[area].get_node(index).shortest_path_known) {
+                return areas[area].max_distance;
+            }
+            return areas[area].get_node(index).distance;
+        }
+
+        void calculate_inter_area_routes() {
+            route_count = 0;
+            for (size_t i = 0; i < summary_count; i++) {
+                const summary &current = summaries[i];
+                cost_type border_distance = get_intra_distance(current.area, current.border);
+                if (border_distance == areas[current.area].max_distance) {
+                    continue;
+                }
+
+                cost_type distance = algebra::combine(border_distance, current.cost);
+                size_t route = find_route(current.destination);
+                if (route == route_count) {
+                    routes[route_count++] = {current.destination, current.area, current.border, distance};
+                } else if (algebra::better(distance, routes[route].distance)) {
+                    routes[route] = {current.destination, current.area, current.border, distance};
+                }
+            }
+        }
+
+    public:
+        /**
+         * \brief Create an area router.
+         *
+         * @param router_id Identifier of this router, used as source node in every area
+         * @param attached_areas Number of areas this router is attached to (at most max_areas)
+         */
+        area_router(const id_type &router_id, const size_t &attached_areas) :
+                areas(make_areas(router_id, std::make_index_sequence<max_areas>())), area_count(attached_areas) {}
+
+        /**
+         * \brief Retrieve the number of areas this router is attached to.
+         *
+         * @return Number of areas
+         */
+        size_t get_area_count() const {
+            return area_count;
+        }
+
+        /**
+         * \brief Retrieve the calculator of an area.
+         *
+         * Call mark_changed() after changing its nodes directly.
+         * @param area Area index
+         * @return The calculator for the area
+         */
+        calculator_type &get_area(const size_t &area) {
+            return areas[area];
+        }
+
+        /**
+         * \brief Mark an area as changed, so update() recalculates it.
+         *
+         * @param area Area index
+         */
+        void mark_changed(const size_t &area) {
+            changed[area] = true;
+        }
+
+        /**
+         * \brief Replace or insert a node in an area, see calculator::insert_replace().
+         *
+         * @param area Area index
+         * @param node The node to insert/replace
+         */
+        void insert_replace(const size_t &area, const node_type &node) {
+            areas[area].insert_replace(node);
+            mark_changed(area);
+        }
+
+        /**
+         * \brief Remove a node from an area, see calculator::remove().
+         *
+         * @param area Area index
+         * @param id Identifier for which to remove a node
+         * @return True if the remove succeeded, false if the node didn't exist
+         */
+        bool remove(const size_t &area, const id_type &id) {
+            if (areas[area].remove(id)) {
+                mark_changed(area);
+                return true;
+            }
+            return false;
+        }
+
+        /**
+         * \brief Add or replace a summary advertised by a border router.
+         *
+         * @param new_summary The summary
+         * @return False if there was no room for a new summary
+         */
+        bool set_summary(const summary &new_summary) {
+            size_t index = find_summary(new_summary.area, new_summary.border, new_summary.destination);
+            if (index == summary_count) {
+                if (summary_count == max_summaries) {
+                    return false;
+                }
+                summary_count++;
+            }
+            summaries[index] = new_summary;
+            summaries_changed = true;
+            return true;
+        }
+
+        /**
+         * \brief Remove a summary.
+         *
+         * @param area Area the summary was received in
+         * @param border Border router advertising the summary
+         * @param destination Destination of the summary
+         * @return True if the summary existed
+         */
+        bool remove_summary(const size_t &area, const id_type &border, const id_type &destination) {
+            size_t index = find_summary(area, border, destination);
+            if (index == summary_count) {
+                return false;
+            }
+            summaries[index] = summaries[--summary_count];
+            summaries_changed = true;
+            return true;
+        }
+
+        /**
+         * \brief Recalculate changed areas, and the inter-area routes if anything changed.
+         *
+         * @return True if anything was recalculated
+         */
+        bool update() {
+            bool any_changed = summaries_changed;
+            for (size_t area = 0; area < area_count; area++) {
+                if (changed[area]) {
+                    areas[area].setup();
+                    areas[area].loop();
+                    changed[area] = false;
+                    any_changed = true;
+                }
+            }
+
+            if (any_changed) {
+                calculate_inter_area_routes();
+                summaries_changed = false;
+            }
+            return any_changed;
+        }
+
+        /**
+         * \brief Call a function for each reachable destination inside an area.
+         *
+         * Used by border routers to create the summaries they advertise into their other areas.
+         * The function is called as function(destination, distance). Call update() first.
+         * @param area Area index
+         * @param function Function to call
+         */
+        template<typename function_type>
+        void for_each_summary(const size_t &area, const function_type &function) {
+            calculator_type &calc = areas[area];
+            for (size_t i = 1; i < calc.get_node_count(); i++) {
+                if (calc.get_node(i).shortest_path_known) {
+                    function(calc.get_node(i).id, calc.get_node(i).distance);
+                }
+            }
+        }
+
+        /**
+         * \brief Get next hop for a destination in any area. Call update() first for accurate results.
+         *
+         * @param id Destination identifier
+         * @return The id of the next hop, or 0 if the destination is unreachable
+         */
+        id_type get_next_hop(const id_type &id) {
+            size_t area = find_intra_area(id);
+            if (area != area_count) {
+                return areas[area].get_next_hop(id);
+            }
+
+            size_t route = find_route(id);
+            if (route == route_count) {
+                return 0;
+            }
+            if (routes[route].border == areas[routes[route].area].get_node(0).id) {
+                return 0;
+            }
+            return areas[routes[route].area].get_next_hop(routes[route].border);
+        }
+
+        /**
+         * \brief Get the distance to a destination in any area. Call update() first for accurate results.
+         *
+         * @param id Destination identifier
+         * @return The distance, or max_distance of the calculators if the destination is unreachable
+         */
+        cost_type get_distance(const id_type &id) {
+            size_t area = find_intra_area(id);
+            if (area != area_count) {
+                return get_intra_distance(area, id);
+            }
+
+            size_t route = find_route(id);
+            if (route == route_count) {
+                return areas[0].max_distance;
+            }
+            return routes[route].distance;
+        }
+    };
+
+    /**
+     * @}
+     */
+}
+
+#endif //IPASS_LINK_STATE_AREA_ROUTER_HPP
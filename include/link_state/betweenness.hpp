@@ -0,0 +1,198 @@
+/*
+ *
+ * Copyright Niels Post 2019.
+ * Distributed under the Boost Software License, Version 1.0.
+ * (See accompanying file LICENSE_1_0.txt or copy at
+ * https://www.boost.org/LICENSE_1_0.txt)
+ *
+*/
+
+#ifndef IPASS_LINK_STATE_BETWEENNESS_HPP
+#define IPASS_LINK_STATE_BETWEENNESS_HPP
+
+#include <link_state/spt_counts.hpp>
+
+namespace link_state {
+
+    /**
+     * \addtogroup link_state
+     * @{
+     */
+
+    /**
+     * \brief Source selection that uses every source, for exact betweenness.
+     */
+    struct every_source {
+        bool operator()(const size_t &) const {
+            return true;
+        }
+    };
+
+    /**
+     * \brief Source selection that uses a pseudo random sample of about one in every one_in sources, for approximate betweenness.
+     *
+     * The sample only depends on the source index and the seed, so it's the same for every thread.
+     */
+    struct sampled_sources {
+        /// Use about one in every one_in sources
+        uint32_t one_in;
+        /// Seed selecting which sources are used
+        uint32_t seed = 0;
+
+        bool operator()(const size_t &source) const {
+            uint32_t x = static_cast<uint32_t>(source) ^ (seed * 0x9E3779B9u);
+            x ^= x >> 16;
+            x *= 0x7FEB352Du;
+            x ^= x >> 15;
+            x *= 0x846CA68Bu;
+            x ^= x >> 16;
+            return x % one_in == 0;
+        }
+    };
+
+    /**
+     * \brief Calculates betweenness centrality of every node and edge: the number of shortest paths between other nodes passing through it.
+     *
+     * Uses Brandes' algorithm, on the costs of the calculator (weighted). Equal cost shortest paths each count for their share (ECMP).
+     * For each source a single shortest path run is done, after which path counts are accumulated top-down (see link_state::spt_counts)
+     * and dependencies bottom-up. Edge costs should be positive.
+     *
+     * Sources are chosen by a selection callable, see link_state::every_source and link_state::sampled_sources.
+     * With a sample, the results are scaled up to estimate the exact betweenness.
+     * Sources can be split over multiple betweenness objects (for example one per thread, see parallel.hpp) and combined with merge().
+     * Results are indexed by node index and edge index, so they're only valid as long as the calculator's nodes aren't changed.
+     * @tparam calculator_type Calculator type holding the network graph
+     * @tparam value_type Datatype for centrality values, should be able to hold fractions
+     */
+    template<typename calculator_type, typename value_type = double>
+    class betweenness {
+    public:
+        using node_type = typename calculator_type::node_type;
+        using state_type = typename calculator_type::state_type;
+
+    private:
+        state_type state = {};
+        spt_counts<calculator_type, value_type> counts = {};
+        std::array<value_type, calculator_type::node_capacity> dependency = {};
+        std::array<value_type, calculator_type::node_capacity> node_centrality = {};
+        std::array<std::array<value_type, calculator_type::edge_capacity>, calculator_type::node_capacity> edge_centrality = {};
+        size_t sampled_count = 0;
+        size_t node_count = 0;
+
+        value_type scale() const {
+            return sampled_count == 0 ? 0 : static_cast<value_type>(node_count) / static_cast<value_type>(sampled_count);
+        }
+
+    public:
+        /**
+         * \brief Set all centrality values to zero.
+         */
+        void reset() {
+            node_centrality.fill(0);
+            for (auto &node_edges : edge_centrality) {
+                node_edges.fill(0);
+            }
+            sampled_count = 0;
+            node_count = 0;
+        }
+
+        /**
+         * \brief Add the shortest paths from a range of sources.
+         *
+         * The selection is called as selection(source_index), and should return true if the source is used.
+         * @param calc Calculator holding the network graph
+         * @param selection Source selection
+         * @param first_source Index of the first source node
+         * @param last_source Index after the last source node
+         */
+        template<typename selection_type>
+        void evaluate(const calculator_type &calc, const selection_type &selection, const size_t &first_source,
+                      const size_t &last_source) {
+            node_count = calc.get_node_count();
+            for (size_t source = first_source; source < last_source; source++) {
+                if (!selection(source)) {
+                    continue;
+                }
+                sampled_count++;
+                calc.run(source, state);
+                counts.count(calc, state);
+
+                // dependency holds the number of paths to each node and every node behind it, weighted by their share
+                for (size_t position = state.known_count; position > 0; position--) {
+                    const size_t from_index = state.order[position - 1];
+                    dependency[from_index] = 0;
+
+                    counts.for_each_dag_edge(calc, state, from_index, [this, &from_index](const size_t &edge_id,
+                                                                                         const size_t &to_index) {
+                        value_type share = counts.get_path_count(from_index) / counts.get_path_count(to_index) *
+                                           (1 + dependency[to_index]);
+                        edge_centrality[from_index][edge_id] += share;
+                        dependency[from_index] += share;
+                    });
+
+                    if (from_index != source) {
+                        node_centrality[from_index] += dependency[from_index];
+                    }
+                }
+            }
+        }
+
+        /**
+         * \brief Calculate the betweenness of all nodes and edges.
+         *
+         * @param calc Calculator holding the network graph
+         * @param selection Source selection, see evaluate(const calculator_type &, const selection_type &, const size_t &, const size_t &)
+         */
+        template<typename selection_type = every_source>
+        void evaluate(const calculator_type &calc, const selection_type &selection = {}) {
+            reset();
+            evaluate(calc, selection, 0, calc.get_node_count());
+        }
+
+        /**
+         * \brief Add the results calculated by another betweenness object.
+         *
+         * @param other Object to add the results of
+         */
+        void merge(const betweenness &other) {
+            for (size_t i = 0; i < calculator_type::node_capacity; i++) {
+                node_centrality[i] += other.node_centrality[i];
+                for (size_t j = 0; j < calculator_type::edge_capacity; j++) {
+                    edge_centrality[i][j] += other.edge_centrality[i][j];
+                }
+            }
+            sampled_count += other.sampled_count;
+            if (other.node_count > node_count) {
+                node_count = other.node_count;
+            }
+        }
+
+        /**
+         * \brief Retrieve the betweenness of a node: the number of shortest paths between other nodes passing through it.
+         *
+         * Paths are directed, so on a network with bidirectional links every pair of nodes is counted twice.
+         * @param node_index Node index
+         * @return Betweenness of the node, estimated if the sources were sampled
+         */
+        value_type get_node_betweenness(const size_t &node_index) const {
+            return node_centrality[node_index] * scale();
+        }
+
+        /**
+         * \brief Retrieve the betweenness of an edge: the number of shortest paths using it.
+         *
+         * @param node_index Index of the node the edge starts at
+         * @param edge_index Index of the edge in node::edges
+         * @return Betweenness of the edge, estimated if the sources were sampled
+         */
+        value_type get_edge_betweenness(const size_t &node_index, const size_t &edge_index) const {
+            return edge_centrality[node_index][edge_index] * scale();
+        }
+    };
+
+    /**
+     * @}
+     */
+}
+
+#endif //IPASS_LINK_STATE_BETWEENNESS_HPP
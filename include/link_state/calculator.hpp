@@ -11,6 +11,8 @@
 #define IPASS_LINK_STATE_CALCULATOR_HPP
 
 #include <link_state/node.hpp>
+#include <link_state/spf_state.hpp>
+#include <link_state/path_algebra.hpp>
 #include <cout_debug.hpp>
 
 namespace link_state {
@@ -28,24 +30,169 @@ namespace link_state {
      * @{
      */
 
+    /**
+     * \brief Edge view that uses every edge with its normal edge cost.
+     *
+     * Edge views are used by calculator::run() to decide which edges may be used, and at what cost.
+     * A view is called as view(from_index, from_node, edge_index, to_index, cost), and should return false to skip the edge.
+     * If the edge is used, cost should be set to the cost of the edge.
+     */
+    struct default_edge_view {
+        template<typename node_type, typename cost_type>
+        constexpr bool operator()(const size_t &, const node_type &from, const size_t &edge_index, const size_t &,
+                        cost_type &cost) const {
+            cost = from.edge_costs[edge_index];
+            return true;
+        }
+    };
+
+    /**
+     * \brief Edge view that gives every edge a cost of 1, to measure distances in hops.
+     */
+    struct hop_edge_view {
+        template<typename node_type, typename cost_type>
+        constexpr bool operator()(const size_t &, const node_type &, const size_t &, const size_t &, cost_type &cost) const {
+            cost = 1;
+            return true;
+        }
+    };
+
+    /**
+     * \brief Node index that scans all nodes for every lookup.
+     *
+     * Node indices are used by the calculator to find nodes by id, see link_state::perfect_hash_index for an alternative.
+     * An index provides find(nodes, node_count, id), invalidate() (called when node indices change), rebuild(nodes, node_count),
+     * which may move nodes other than the source node to other indices, and is_constant_time(node_count), true if find() currently doesn't scan.
+     */
+    struct linear_index {
+        template<typename node_array, typename id_type>
+        constexpr size_t find(const node_array &nodes, const size_t &node_count, const id_type &id) const {
+            for (size_t i = 0; i < node_count; i++) {
+                if (nodes[i].id == id) {
+                    return i;
+                }
+            }
+            return node_count;
+        }
+
+        constexpr void invalidate() {}
+
+        template<typename node_array>
+        constexpr bool rebuild(node_array &, const size_t &) {
+            return true;
+        }
+
+        constexpr bool is_constant_time(const size_t &) const {
+            return false;
+        }
+    };
+
     /**
      * \brief Link State Calculator. Calculates shortest path from a source node to any node in the network.
      *
      * Calculator assumes node index 0 to always be the source node. Make sure this is correctly set for any use of this module.
      * THe link state algorithm is used to find the shortest route for the current state of the given network graph.
      * @tparam id_type Datatype that is used for node identifiers
-     * @tparam cost_type Datatype used for edge costs, calculator automatically calculates the max value for the given datatype based on it's size. Make sure this datatype is large enough to hold summed distances as well.
+     * @tparam cost_type Datatype used for edge costs. Make sure this datatype is large enough to hold summed distances as well, or use link_state::saturating_shortest_path as algebra.
      * @tparam max_edges Maximum number of edges each node can hold. Keeping this at a minimum saves memory space.
      * @tparam max_nodes Maximum number of nodes in the network graph. Keeping this at a minimum saves memory space.
+     * @tparam node_extension Extra per-edge attributes stored in every node, see link_state::node
+     * @tparam algebra Path algebra deciding how costs are combined and compared, see link_state::shortest_path
+     * @tparam id_index Index used to find nodes by id, see link_state::linear_index
+     * @tparam hop_type Datatype for hop counts, used to prefer the path with the fewest hops of two equal cost paths.
+     * void (the default) stores no hop counts, equal cost paths then keep the path found first
      */
-    template<typename id_type, typename cost_type, size_t max_edges, size_t max_nodes>
+    template<typename id_type, typename cost_type, size_t max_edges, size_t max_nodes, typename node_extension = no_extension,
+            typename algebra = shortest_path<cost_type>, typename id_index = linear_index, typename hop_type = void>
     class calculator {
+    public:
+        /// Identifier type used by this calculator
+        using id_t = id_type;
+        /// Cost type used by this calculator
+        using cost_t = cost_type;
+        /// Node type stored by this calculator
+        using node_type = node<id_type, cost_type, max_edges, node_extension, hop_type>;
+        /// Result type for calculator::run()
+        using state_type = spf_state<cost_type, max_nodes, hop_type>;
+        /// Path algebra used by this calculator
+        using algebra_type = algebra;
+
+        /// Maximum number of edges per node
+        static constexpr size_t edge_capacity = max_edges;
+        /// Maximum number of nodes
+        static constexpr size_t node_capacity = max_nodes;
+        /// Are ties between equal cost paths broken on hop count
+        static constexpr bool hop_tie_break = !std::is_void<hop_type>::value;
+
     private:
-        std::array<node<id_type, cost_type, max_edges>, max_nodes>
+        std::array<node_type, max_nodes>
                 nodes = {};
         size_t node_count = 0;
+        id_index index = {};
+
+        /**
+         * \brief Make the closest unknown node known, and update the distances of its neighbours.
+         *
+         * @return Index of the node that became known, or node_count if all remaining nodes are unreachable
+         */
+        constexpr size_t settle_next() {
+            cost_type min_distance = max_distance;
+            size_t min_distance_node = 0;
+            for (size_t i = 1; i < node_count; i++) {
+                node_type &check_node = nodes[i];
+                if (check_node.shortest_path_known) {
+                    continue;
+                }
+
+                if (algebra::better(check_node.distance, min_distance) ||
+                    (min_distance_node != 0 && check_node.distance == min_distance &&
+                     check_node.id < nodes[min_distance_node].id)) {
+                    min_distance = check_node.distance;
+                    min_distance_node = i;
+                }
+            }
+
+            if (min_distance == max_distance) { //Fucked, ABORT todo: request routing update
+                return node_count;
+            }
+
+            node_type &current_node = nodes[min_distance_node];
+
+
+            for (size_t edge_id = 0; edge_id < current_node.edge_count; edge_id++) {
+                auto neighbour_index = get_index_by_id(current_node.edges[edge_id]);
+                if (neighbour_index == node_count) {
+                    // We don't know this node, todo request routing update, propagate through previous_hops to find next_hop
+                    continue;
+                }
+
+                node_type &neighbour = nodes[neighbour_index];
+
+                if (neighbour.shortest_path_known) {
+                    continue;
+                }
+
+                cost_type distance = algebra::combine(current_node.distance, current_node.edge_costs[edge_id]);
+                bool improves = algebra::better(distance, neighbour.distance);
+                if constexpr (hop_tie_break) {
+                    improves = improves || (distance == neighbour.distance && current_node.hop_count + 1 < neighbour.hop_count);
+                }
+                if (improves) {
+                    neighbour.distance = distance;
+                    neighbour.previous_node = current_node.id;
+                    if constexpr (hop_tie_break) {
+                        neighbour.hop_count = static_cast<hop_type>(current_node.hop_count + 1);
+                    }
+                }
+
+            }
+
+            current_node.shortest_path_known = true;
+            return min_distance_node;
+        }
+
     public:
-        /// Calculated maximum distance for this cost_type
+        /// Distance of unreachable nodes, as given by the path algebra
         cost_type max_distance;
 
         /**
@@ -53,15 +200,9 @@ namespace link_state {
          *
          * @param source_id Identifier for the source node (index 0)
          */
-        explicit calculator(id_type source_id) {
-            cost_type temp = 0;
-            for (size_t i = 0; i < sizeof(cost_type); i++) {
-                temp <<= 8;
-                temp |= 0xFF;
-            }
-            max_distance = temp;
+        constexpr explicit calculator(id_type source_id) : max_distance(algebra::unreachable()) {
             nodes[0].id = source_id;
-            nodes[0].distance = 0;
+            nodes[0].distance = algebra::source();
             node_count++;
         }
 
@@ -73,7 +214,17 @@ namespace link_state {
          * @param index Node index
          * @return  The node at the given index.
          */
-        node<id_type, cost_type, max_edges> &get_node(const size_t &index) {
+        constexpr node_type &get_node(const size_t &index) {
+            return nodes[index];
+        }
+
+        /**
+         * \brief Retrieve a node's current state, without allowing changes.
+         *
+         * @param index Node index
+         * @return  The node at the given index.
+         */
+        constexpr const node_type &get_node(const size_t &index) const {
             return nodes[index];
         }
 
@@ -82,7 +233,7 @@ namespace link_state {
          *
          * @return Number of nodes
          */
-        size_t get_node_count() const {
+        constexpr size_t get_node_count() const {
             return node_count;
         }
 
@@ -93,13 +244,92 @@ namespace link_state {
          * @param id Identifier to check for.
          * @return The index of the node, or node_count
          */
-        size_t get_index_by_id(const id_type &id) {
+        constexpr size_t get_index_by_id(const id_type &id) const {
+            return index.find(nodes, node_count, id);
+        }
+
+        /**
+         * \brief Rebuild the node index, after a batch of inserts or removes.
+         *
+         * Only needed for indices that don't update themselves, like link_state::perfect_hash_index.
+         * The index may move nodes to other indices (undoing reorder()), the source node stays at index 0.
+         * @return False if the index couldn't be built
+         */
+        constexpr bool rebuild_index() {
+            return index.rebuild(nodes, node_count);
+        }
+
+        /**
+         * \brief Reorder the nodes in memory, so nodes that are close in the network are close in memory as well.
+         *
+         * Uses Cuthill-McKee ordering from the source node: a breadth first search that visits the neighbours of each node in order of increasing degree.
+         * The order isn't reversed (as in reverse Cuthill-McKee), so the source node stays at index 0. Unreachable nodes are kept after the reachable ones.
+         * Ids, edges and routing information don't change, only node indices do.
+         * The node index is invalidated. Rebuilding a link_state::perfect_hash_index with move_nodes (the default) moves the nodes into hash order
+         * again, undoing the reordering, so the two are mutually exclusive; use move_nodes = false to keep this order and hash the nodes where they are.
+         */
+        constexpr void reorder() {
+            std::array<size_t, max_nodes> order = {};
+            std::array<bool, max_nodes> visited = {};
+            size_t order_end = 0;
+            order[order_end++] = 0;
+            visited[0] = true;
+
+            for (size_t next_start = 0; order_end < node_count; next_start++) {
+                if (next_start == order_end) {
+                    // Continue with the first node that wasn't reached
+                    size_t unreached = 0;
+                    while (visited[unreached]) {
+                        unreached++;
+                    }
+                    order[order_end++] = unreached;
+                    visited[unreached] = true;
+                }
+
+                const node_type &current_node = nodes[order[next_start]];
+                size_t first_neighbour = order_end;
+                for (size_t edge_id = 0; edge_id < current_node.edge_count; edge_id++) {
+                    size_t neighbour_index = get_index_by_id(current_node.edges[edge_id]);
+                    if (neighbour_index == node_count || visited[neighbour_index]) {
+                        continue;
+                    }
+                    visited[neighbour_index] = true;
+
+                    // Insertion sort of the new neighbours on degree, then id
+                    size_t position = order_end++;
+                    while (position > first_neighbour &&
+                           (nodes[order[position - 1]].edge_count > nodes[neighbour_index].edge_count ||
+                            (nodes[order[position - 1]].edge_count == nodes[neighbour_index].edge_count &&
+                             nodes[neighbour_index].id < nodes[order[position - 1]].id))) {
+                        order[position] = order[position - 1];
+                        position--;
+                    }
+                    order[position] = neighbour_index;
+                }
+            }
+
+            // Move every node to its new index, following each cycle of the permutation
             for (size_t i = 0; i < node_count; i++) {
-                if (nodes[i].id == id) {
-                    return i;
+                visited[i] = false;
+            }
+            for (size_t start = 0; start < node_count; start++) {
+                if (visited[start]) {
+                    continue;
+                }
+                node_type moved = nodes[start];
+                size_t target = start;
+                while (true) {
+                    visited[target] = true;
+                    size_t source_index = order[target];
+                    if (source_index == start) {
+                        nodes[target] = moved;
+                        break;
+                    }
+                    nodes[target] = nodes[source_index];
+                    target = source_index;
                 }
             }
-            return node_count;
+            index.invalidate();
         }
 
         /**
@@ -108,12 +338,13 @@ namespace link_state {
          * Will replace the node based on current identifier, any other part of node state won't be checked for.
          * @param node The node to insert/replace
          */
-        void insert_replace(node<id_type, cost_type, max_edges> node) {
+        constexpr void insert_replace(node_type node) {
             size_t existing_node = get_index_by_id(node.id);
             nodes[existing_node] = node;
 
             if (existing_node == node_count) {
                 node_count++;
+                index.invalidate();
             }
         }
 
@@ -123,7 +354,7 @@ namespace link_state {
          * @param id Identifier for which to remove a node
          * @return True if the remove succeeded, false if the node didn't exist
          */
-        bool remove(const id_type &id) {
+        constexpr bool remove(const id_type &id) {
             size_t node_index = get_index_by_id(id);
             if (node_index != node_count && node_index != 0) {
                 node_count--;
@@ -131,6 +362,7 @@ namespace link_state {
                     nodes[i] = nodes[i + 1];
                 }
                 nodes[node_count] = {};
+                index.invalidate();
                 return true;
             }
             return false;
@@ -139,13 +371,14 @@ namespace link_state {
         /**
          * \brief Get next hop for a given node id. Note that setup and loop need to have been called in the current network state for accurate results.
          *
-         * Propagates through previous_nodes until the source node is reached, and returns the last node before that
+         * Propagates through previous_nodes until the source node is reached, and returns the last node before that.
+         * Only nodes with a known shortest path have a next hop, so this is safe to use on the partial results of loop_step() and loop_for().
          * @param id ID to find next hop for
          * @return The id of the next hop
          */
-        id_type get_next_hop(const id_type &id) {
+        constexpr id_type get_next_hop(const id_type &id) const {
             size_t node_index = get_index_by_id(id);
-            if (node_index == node_count) {
+            if (node_index == node_count || !nodes[node_index].shortest_path_known) {
                 return 0;
             }
 
@@ -180,18 +413,27 @@ namespace link_state {
          * Sets all "shortest_path_known"'s to false, except for the source node.
          * Adds the initial distance of all direct neighbours of the source node.
          */
-        void setup() {
-            node<id_type, cost_type, max_edges> &source_node = nodes[0];
+        constexpr void setup() {
+            node_type &source_node = nodes[0];
             source_node.shortest_path_known = true;
+            source_node.distance = algebra::source();
+            if constexpr (hop_tie_break) {
+                source_node.hop_count = 0;
+            }
 
             for (size_t i = 1; i < node_count; i++) {
-                node<id_type, cost_type, max_edges> &current_node = nodes[i];
+                node_type &current_node = nodes[i];
                 current_node.shortest_path_known = false;
                 current_node.distance = max_distance;
                 for (size_t j = 0; j < source_node.edge_count; j++) {
-                    if (source_node.edges[j] == current_node.id && source_node.edge_costs[j] < current_node.distance) {
-                        current_node.distance = source_node.edge_costs[j];
+                    if (source_node.edges[j] == current_node.id &&
+                        algebra::better(algebra::combine(source_node.distance, source_node.edge_costs[j]),
+                                        current_node.distance)) {
+                        current_node.distance = algebra::combine(source_node.distance, source_node.edge_costs[j]);
                         current_node.previous_node = source_node.id;
+                        if constexpr (hop_tie_break) {
+                            current_node.hop_count = 1;
+                        }
                         break;
                     }
                 }
@@ -203,62 +445,208 @@ namespace link_state {
          *
          * Loops through all nodes until all nodes have shortest_path_known = true, or the remaining nodes are all definitively unreachable.
          * Calculates the minimum distance for each node, and sets previous node.
+         * Ties are broken deterministically, so the result doesn't depend on the order of the nodes:
+         * nodes with equal distance are handled lowest id first, inside the selection scan, so relaxations happen in the same order on every router.
+         * Of two equal cost paths the first one found is kept, or the one with the fewest hops if the calculator has a hop_type.
          */
-        void loop() {
-            for (size_t definitive_node_count = 1; definitive_node_count < node_count; definitive_node_count++) {
-                cost_type min_distance = max_distance;
-                size_t min_distance_node = 0;
-                for (size_t i = 1; i < node_count; i++) {
-                    node<id_type, cost_type, max_edges> &check_node = nodes[i];
-                    if (check_node.shortest_path_known) {
-                        continue;
+        constexpr void loop() {
+            while (settle_next() != node_count) {}
+        }
+
+        /**
+         * \brief Resumable loop phase, making at most max_steps nodes known per call.
+         *
+         * Call setup() once, then call loop_step() until it returns true, so other tasks can run in between.
+         * The result is the same as that of loop(). Nodes made known so far already have their final path,
+         * so get_next_hop() is accurate for them. Don't change nodes before the run is finished, or call setup() again after changing them.
+         * @param max_steps Maximum number of nodes to make known in this call
+         * @return True if the loop phase is finished
+         */
+        constexpr bool loop_step(const size_t &max_steps) {
+            for (size_t step = 0; step < max_steps; step++) {
+                if (settle_next() == node_count) {
+                    return true;
+                }
+            }
+            return false;
+        }
+
+        /**
+         * \brief Anytime loop phase, making nodes known until the budget runs out.
+         *
+         * The budget is called after each node that becomes known, and should return false once the time or work budget is used up
+         * (for example by comparing a timer against a deadline). At least one node is made known per call.
+         * Nodes become known closest first, and their paths are final, so routes to nearby destinations are available first.
+         * Use is_known() to check which destinations are final, and call loop_for() again to continue, as with loop_step().
+         * @param budget Callable returning true while there is budget left
+         * @return True if the loop phase is finished
+         */
+        template<typename budget_type>
+        constexpr bool loop_for(const budget_type &budget) {
+            do {
+                if (settle_next() == node_count) {
+                    return true;
+                }
+            } while (budget());
+            return false;
+        }
+
+        /**
+         * \brief Loop phase that publishes routes to priority destinations as soon as they are final.
+         *
+         * Call setup() first. publish is called as publish(id, next_hop) for each priority destination, the moment its shortest path becomes known.
+         * With stop_when_known, the run stops once all priority destinations are known, and can be continued later with loop(), loop_step() or loop_for().
+         * Priority destinations that don't exist or are already known aren't published.
+         * @param priority_ids Identifiers of the priority destinations, without duplicates
+         * @param priority_count Number of priority destinations
+         * @param publish Callable receiving the routes to priority destinations
+         * @param stop_when_known Stop as soon as all priority destinations are known
+         * @return True if the loop phase is finished
+         */
+        template<typename publish_type>
+        constexpr bool loop_priority(const id_type *priority_ids, const size_t &priority_count, const publish_type &publish,
+                                     const bool &stop_when_known = false) {
+            size_t remaining = 0;
+            for (size_t i = 0; i < priority_count; i++) {
+                size_t node_index = get_index_by_id(priority_ids[i]);
+                if (node_index != node_count && !nodes[node_index].shortest_path_known) {
+                    remaining++;
+                }
+            }
+
+            while (!stop_when_known || remaining > 0) {
+                size_t known_index = settle_next();
+                if (known_index == node_count) {
+                    return true;
+                }
+
+                for (size_t i = 0; i < priority_count && remaining > 0; i++) {
+                    if (priority_ids[i] == nodes[known_index].id) {
+                        publish(priority_ids[i], get_next_hop(priority_ids[i]));
+                        remaining--;
+                        break;
                     }
+                }
+            }
+            return false;
+        }
+
+        /**
+         * \brief Calculate the route to a single destination, stopping as soon as its shortest path is known.
+         *
+         * Runs setup() and the loop phase, but only until the destination is known. Nodes further away than the destination stay unknown,
+         * so get_next_hop() returns 0 for them until the next full run.
+         * @param id Identifier of the destination
+         * @return The id of the next hop, or 0 if the destination is unknown or unreachable
+         */
+        constexpr id_type compute_to(const id_type &id) {
+            setup();
+            size_t target_index = get_index_by_id(id);
+            if (target_index == node_count) {
+                return 0;
+            }
+
+            while (!nodes[target_index].shortest_path_known && settle_next() != node_count) {}
+            return get_next_hop(id);
+        }
+
+        /**
+         * \brief Check if the shortest path to a node is final.
+         *
+         * During a run (see loop_step() and loop_for()), this tells which routes can already be used.
+         * @param id Identifier of the node
+         * @return True if the node is known and its shortest path is final
+         */
+        constexpr bool is_known(const id_type &id) const {
+            size_t node_index = get_index_by_id(id);
+            return node_index != node_count && nodes[node_index].shortest_path_known;
+        }
+
+        /**
+         * \brief Calculate shortest paths from any node, without changing routing information in the nodes.
+         *
+         * Edges are pruned and costed by the given edge view during relaxation, so constrained runs don't need a filtered copy of the graph.
+         * See link_state::default_edge_view for the view interface. Ties are broken the same way as in loop().
+         * @param source_index Index of the node to start from
+         * @param state State to write the results into
+         * @param view Edge view deciding which edges are used and what they cost
+         * @param stop_index Stop as soon as the node at this index is known, leaving the remaining nodes unknown
+         */
+        template<typename edge_view = default_edge_view>
+        constexpr void run(const size_t &source_index, state_type &state, const edge_view &view = {},
+                 const size_t &stop_index = state_type::no_node) const {
+            for (size_t i = 0; i < node_count; i++) {
+                state.distance[i] = max_distance;
+                state.previous[i] = state_type::no_node;
+                state.shortest_path_known[i] = false;
+            }
+            state.source = source_index;
+            state.known_count = 0;
+            state.distance[source_index] = algebra::source();
+            state.previous[source_index] = source_index;
+            if constexpr (hop_tie_break) {
+                state.hops[source_index] = 0;
+            }
 
-                    if (check_node.distance < min_distance) {
-                        min_distance = check_node.distance;
+            for (size_t definitive_node_count = 0; definitive_node_count < node_count; definitive_node_count++) {
+                cost_type min_distance = max_distance;
+                size_t min_distance_node = node_count;
+                for (size_t i = 0; i < node_count; i++) {
+                    if (!state.shortest_path_known[i] &&
+                        (algebra::better(state.distance[i], min_distance) ||
+                         (min_distance_node != node_count && state.distance[i] == min_distance &&
+                          nodes[i].id < nodes[min_distance_node].id))) {
+                        min_distance = state.distance[i];
                         min_distance_node = i;
                     }
                 }
 
-                if (min_distance == max_distance) { //Fucked, ABORT todo: request routing update
+                if (min_distance_node == node_count) {
                     return;
                 }
 
-                node<id_type, cost_type, max_edges> &current_node = nodes[min_distance_node];
-
+                const node_type &current_node = nodes[min_distance_node];
+                state.shortest_path_known[min_distance_node] = true;
+                state.order[state.known_count++] = min_distance_node;
+                if (min_distance_node == stop_index) {
+                    return;
+                }
 
                 for (size_t edge_id = 0; edge_id < current_node.edge_count; edge_id++) {
-                    auto neighbour_index = get_index_by_id(current_node.edges[edge_id]);
-                    if (neighbour_index == node_count) {
-                        // We don't know this node, todo request routing update, propagate through previous_hops to find next_hop
+                    size_t neighbour_index = get_index_by_id(current_node.edges[edge_id]);
+                    if (neighbour_index == node_count || state.shortest_path_known[neighbour_index]) {
                         continue;
                     }
 
-                    node<id_type, cost_type, max_edges> &neighbour = nodes[neighbour_index];
-
-                    if (neighbour.shortest_path_known) {
+                    cost_type edge_cost = 0;
+                    if (!view(min_distance_node, current_node, edge_id, neighbour_index, edge_cost)) {
                         continue;
                     }
 
-                    if ((current_node.distance + current_node.edge_costs[edge_id]) < neighbour.distance) {
-                        neighbour.distance = (current_node.distance + current_node.edge_costs[edge_id]);
-                        neighbour.previous_node = current_node.id;
+                    cost_type distance = algebra::combine(min_distance, edge_cost);
+                    bool improves = algebra::better(distance, state.distance[neighbour_index]);
+                    if constexpr (hop_tie_break) {
+                        improves = improves || (distance == state.distance[neighbour_index] &&
+                                                state.hops[min_distance_node] + 1 < state.hops[neighbour_index]);
+                    }
+                    if (improves) {
+                        state.distance[neighbour_index] = distance;
+                        state.previous[neighbour_index] = min_distance_node;
+                        if constexpr (hop_tie_break) {
+                            state.hops[neighbour_index] = static_cast<hop_type>(state.hops[min_distance_node] + 1);
+                        }
                     }
-
                 }
-
-                current_node.shortest_path_known = true;
             }
-
         }
 
-
         /**
          * \brief Clean up any unreachable nodes
          *
-         * Calls setup and loop first, otherwise we would be removing connected nodes
+         * Calls setup and loop first, otherwise we would be removing connected nodes.
+         * Use remove_unreachable() instead if the routing information isn't needed.
          */
-        void cleanup(bool calculate = false) {
+        constexpr void cleanup(bool calculate = false) {
             if (calculate) {
                 setup();
                 loop();
@@ -272,6 +660,98 @@ namespace link_state {
                 }
             }
         }
+
+        /**
+         * \brief Remove all nodes that can't be reached from the source node, without calculating any distances.
+         *
+         * Reachability is found with a breadth first search over the edges, after which all unreachable nodes are removed in a single pass.
+         * If the node index has constant time lookups (a valid link_state::perfect_hash_index), edge ids are looked up through it and the pass is O(N + E).
+         * Otherwise they're looked up in a table of node indices sorted by id (heap sort, then binary search), built once per call,
+         * which makes the pass O((N + E) log N).
+         * Routing information in the nodes isn't changed, call setup() and loop() afterwards if it is needed.
+         * @return Number of removed nodes
+         */
+        constexpr size_t remove_unreachable() {
+            const bool direct = index.is_constant_time(node_count);
+
+            // Heap sort node indices on id
+            std::array<size_t, max_nodes> by_id = {};
+            for (size_t i = 0; i < node_count && !direct; i++) {
+                by_id[i] = i;
+            }
+            for (size_t heap_size = direct ? 0 : node_count, start = heap_size / 2; heap_size > 1;) {
+                if (start > 0) {
+                    start--;
+                } else {
+                    heap_size--;
+                    size_t largest = by_id[0];
+                    by_id[0] = by_id[heap_size];
+                    by_id[heap_size] = largest;
+                }
+                for (size_t parent = start, child = 2 * parent + 1; child < heap_size; parent = child, child = 2 * parent + 1) {
+                    if (child + 1 < heap_size && nodes[by_id[child]].id < nodes[by_id[child + 1]].id) {
+                        child++;
+                    }
+                    if (!(nodes[by_id[parent]].id < nodes[by_id[child]].id)) {
+                        break;
+                    }
+                    size_t moved = by_id[parent];
+                    by_id[parent] = by_id[child];
+                    by_id[child] = moved;
+                }
+            }
+
+            std::array<bool, max_nodes> reached = {};
+            std::array<size_t, max_nodes> queue = {};
+            size_t queue_end = 0;
+            reached[0] = true;
+            queue[queue_end++] = 0;
+
+            for (size_t queue_start = 0; queue_start < queue_end; queue_start++) {
+                const node_type &current_node = nodes[queue[queue_start]];
+                for (size_t edge_id = 0; edge_id < current_node.edge_count; edge_id++) {
+                    const id_type &neighbour_id = current_node.edges[edge_id];
+                    size_t neighbour_index = node_count;
+                    if (direct) {
+                        neighbour_index = get_index_by_id(neighbour_id);
+                    } else {
+                        size_t low = 0;
+                        size_t high = node_count;
+                        while (low < high) {
+                            size_t middle = low + (high - low) / 2;
+                            if (nodes[by_id[middle]].id < neighbour_id) {
+                                low = middle + 1;
+                            } else {
+                                high = middle;
+                            }
+                        }
+                        if (low != node_count && nodes[by_id[low]].id == neighbour_id) {
+                            neighbour_index = by_id[low];
+                        }
+                    }
+                    if (neighbour_index != node_count && !reached[neighbour_index]) {
+                        reached[neighbour_index] = true;
+                        queue[queue_end++] = neighbour_index;
+                    }
+                }
+            }
+
+            size_t kept = 0;
+            for (size_t i = 0; i < node_count; i++) {
+                if (reached[i]) {
+                    nodes[kept++] = nodes[i];
+                }
+            }
+            size_t removed = node_count - kept;
+            for (size_t i = kept; i < node_count; i++) {
+                nodes[i] = {};
+            }
+            node_count = kept;
+            if (removed > 0) {
+                index.invalidate();
+            }
+            return removed;
+        }
     };
 
     /**
@@ -0,0 +1,244 @@
+/*
+ *
+ * Copyright Niels Post 2019.
+ * Distributed under the Boost Software License, Version 1.0.
+ * (See accompanying file LICENSE_1_0.txt or copy at
+ * https://www.boost.org/LICENSE_1_0.txt)
+ *
+*/
+
+#ifndef IPASS_LINK_STATE_CHANGE_QUEUE_HPP
+#define IPASS_LINK_STATE_CHANGE_QUEUE_HPP
+
+#include <stdint.h>
+#include <array>
+#include <atomic>
+
+namespace link_state {
+
+    /**
+     * \addtogroup link_state
+     * @{
+     */
+
+    /**
+     * \brief A single topology mutation, as queued in link_state::change_queue.
+     *
+     * @tparam id_type Datatype for node identifiers, should match the calculator's id_type
+     * @tparam cost_type Datatype for edge costs, should match the calculator's cost_type
+     */
+    template<typename id_type, typename cost_type>
+    struct topology_change {
+        enum class kind : uint8_t {
+            /// Add the edge from -> to, or change its cost if it exists. Unknown nodes are inserted
+            set_edge,
+            /// Remove the edge from -> to
+            remove_edge,
+            /// Remove node from and its own edges, like calculator::remove()
+            remove_node
+        };
+
+        /// Type of change
+        kind type;
+        /// Node owning the edge (or the node to remove)
+        id_type from;
+        /// Other end of the edge
+        id_type to;
+        /// New cost of the edge (set_edge only)
+        cost_type cost;
+    };
+
+    /**
+     * \brief Apply a topology change to a calculator.
+     *
+     * Only node::edges and node::edge_costs are changed, per-edge attributes of a node extension aren't kept in sync,
+     * use calculator::insert_replace() for nodes with extended attributes.
+     * @param calc Calculator to change
+     * @param change The change
+     * @return False if the change couldn't be applied (unknown node or edge, or no room for another edge or node)
+     */
+    template<typename calculator_type, typename id_type, typename cost_type>
+    bool apply_change(calculator_type &calc, const topology_change<id_type, cost_type> &change) {
+        using change_kind = typename topology_change<id_type, cost_type>::kind;
+        if (change.type == change_kind::remove_node) {
+            return calc.remove(change.from);
+        }
+
+        size_t index = calc.get_index_by_id(change.from);
+        if (index == calc.get_node_count()) {
+            if (change.type == change_kind::remove_edge || index == calculator_type::node_capacity) {
+                return false;
+            }
+            calc.insert_replace(typename calculator_type::node_type(change.from));
+        }
+
+        auto &current = calc.get_node(index);
+        size_t edge = 0;
+        while (edge < current.edge_count && current.edges[edge] != change.to) {
+            edge++;
+        }
+
+        if (change.type == change_kind::set_edge) {
+            if (edge == calculator_type::edge_capacity) {
+                return false;
+            }
+            if (edge == current.edge_count) {
+                current.edges[edge] = change.to;
+                current.edge_count++;
+            }
+            current.edge_costs[edge] = change.cost;
+            return true;
+        }
+
+        if (edge == current.edge_count) {
+            return false;
+        }
+        current.edge_count--;
+        for (; edge < current.edge_count; edge++) {
+            current.edges[edge] = current.edges[edge + 1];
+            current.edge_costs[edge] = current.edge_costs[edge + 1];
+        }
+        return true;
+    }
+
+    /**
+     * \brief Back-pressure statistics of a link_state::change_queue.
+     */
+    struct change_queue_statistics {
+        /// Number of changes pushed successfully
+        size_t pushed;
+        /// Number of pushes rejected because the queue was full
+        size_t rejected;
+        /// Number of changes taken out of the queue
+        size_t drained;
+        /// Highest number of changes waiting in the queue at once
+        size_t max_depth;
+    };
+
+    /**
+     * \brief Bounded lock-free queue of topology changes, from any number of producer threads to a single consumer.
+     *
+     * Receiver threads push() changes, and the SPF thread calls drain() before each calculation to apply them in one batch.
+     * All storage is inside the queue, nothing is allocated. Every slot has a sequence number telling producers and the consumer
+     * whether it is free or filled, so pushes only contend on one atomic increment.
+     * @tparam id_type Datatype for node identifiers, should match the calculator's id_type
+     * @tparam cost_type Datatype for edge costs, should match the calculator's cost_type
+     * @tparam capacity Maximum number of queued changes, must be a power of two
+     */
+    template<typename id_type, typename cost_type, size_t capacity>
+    class change_queue {
+        static_assert(capacity >= 2 && (capacity & (capacity - 1)) == 0, "Queue capacity must be a power of two");
+
+    public:
+        using change_type = topology_change<id_type, cost_type>;
+
+    private:
+        struct cell {
+            std::atomic<size_t> sequence;
+            change_type change;
+        };
+
+        std::array<cell, capacity> cells;
+        alignas(64) std::atomic<size_t> enqueue_position;
+        alignas(64) std::atomic<size_t> dequeue_position;
+        alignas(64) std::atomic<size_t> rejected;
+        std::atomic<size_t> max_depth;
+
+    public:
+        change_queue() : enqueue_position(0), dequeue_position(0), rejected(0), max_depth(0) {
+            for (size_t i = 0; i < capacity; i++) {
+                cells[i].sequence.store(i, std::memory_order_relaxed);
+            }
+        }
+
+        /**
+         * \brief Add a change to the queue. Safe to call from any thread.
+         *
+         * @param change The change
+         * @return False if the queue is full
+         */
+        bool push(const change_type &change) {
+            size_t position = enqueue_position.load(std::memory_order_relaxed);
+            cell *target = nullptr;
+            while (true) {
+                target = &cells[position & (capacity - 1)];
+                size_t sequence = target->sequence.load(std::memory_order_acquire);
+                if (sequence == position) {
+                    if (enqueue_position.compare_exchange_weak(position, position + 1, std::memory_order_relaxed)) {
+                        break;
+                    }
+                } else if (static_cast<intptr_t>(sequence - position) < 0) {
+                    rejected.fetch_add(1, std::memory_order_relaxed);
+                    return false;
+                } else {
+                    position = enqueue_position.load(std::memory_order_relaxed);
+                }
+            }
+
+            // Measured before publishing, so the consumer can't have passed this position yet
+            size_t depth = position + 1 - dequeue_position.load(std::memory_order_relaxed);
+            size_t known_depth = max_depth.load(std::memory_order_relaxed);
+            while (depth > known_depth && !max_depth.compare_exchange_weak(known_depth, depth, std::memory_order_relaxed)) {}
+
+            target->change = change;
+            target->sequence.store(position + 1, std::memory_order_release);
+            return true;
+        }
+
+        /**
+         * \brief Take the oldest change out of the queue. Should only be called by the consumer thread.
+         *
+         * @param change Variable to write the change into
+         * @return False if the queue is empty
+         */
+        bool pop(change_type &change) {
+            size_t position = dequeue_position.load(std::memory_order_relaxed);
+            cell &source = cells[position & (capacity - 1)];
+            if (source.sequence.load(std::memory_order_acquire) != position + 1) {
+                return false;
+            }
+
+            change = source.change;
+            source.sequence.store(position + capacity, std::memory_order_release);
+            dequeue_position.store(position + 1, std::memory_order_relaxed);
+            return true;
+        }
+
+        /**
+         * \brief Apply queued changes to a calculator, see link_state::apply_change(). Should only be called by the consumer thread.
+         *
+         * Changes pushed while draining are only applied if max_changes allows it.
+         * Call calculator::setup() and calculator::loop() afterwards.
+         * @param calc Calculator to change
+         * @param max_changes Maximum number of changes to apply
+         * @return Number of changes taken out of the queue
+         */
+        template<typename calculator_type>
+        size_t drain(calculator_type &calc, const size_t &max_changes = capacity) {
+            size_t count = 0;
+            change_type change = {};
+            while (count < max_changes && pop(change)) {
+                apply_change(calc, change);
+                count++;
+            }
+            return count;
+        }
+
+        /**
+         * \brief Retrieve the back-pressure statistics of the queue. Safe to call from any thread.
+         *
+         * @return The statistics
+         */
+        change_queue_statistics get_statistics() const {
+            size_t drained = dequeue_position.load(std::memory_order_relaxed);
+            return {enqueue_position.load(std::memory_order_relaxed), rejected.load(std::memory_order_relaxed), drained,
+                    max_depth.load(std::memory_order_relaxed)};
+        }
+    };
+
+    /**
+     * @}
+     */
+}
+
+#endif //IPASS_LINK_STATE_CHANGE_QUEUE_HPP
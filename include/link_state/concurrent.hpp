@@ -0,0 +1,186 @@
+/*
+ *
+ * Copyright Niels Post 2019.
+ * Distributed under the Boost Software License, Version 1.0.
+ * (See accompanying file LICENSE_1_0.txt or copy at
+ * https://www.boost.org/LICENSE_1_0.txt)
+ *
+*/
+
+#ifndef IPASS_LINK_STATE_CONCURRENT_HPP
+#define IPASS_LINK_STATE_CONCURRENT_HPP
+
+#include <mutex>
+#include <shared_mutex>
+#include <type_traits>
+#include <link_state/calculator.hpp>
+#include <link_state/route_table.hpp>
+
+namespace link_state {
+
+    /**
+     * \addtogroup link_state
+     * @{
+     */
+
+    /**
+     * \brief Calculator wrapper accepting topology updates from multiple threads.
+     *
+     * Receiver threads call insert_replace() and remove(), which only lock one stripe of pending changes (selected by node id),
+     * so receivers for different nodes don't block each other. A single SPF thread calls update(),
+     * which takes the pending changes of each stripe, applies them to the calculator and recalculates.
+     * Changes for the same id always go to the same stripe, so they are applied in the order they were made.
+     *
+     * Next hops are read from a published link_state::route_table, so readers never wait for updates or calculation,
+     * only for the moment a new table is published.
+     *
+     * This header uses std::mutex and std::shared_mutex, so it should only be included on targets that support threads.
+     * @tparam calculator_type Calculator type holding the network graph
+     * @tparam stripe_count Number of stripes (independent locks)
+     * @tparam stripe_capacity Maximum number of pending changes per stripe
+     */
+    template<typename calculator_type, size_t stripe_count, size_t stripe_capacity>
+    class concurrent_calculator {
+    public:
+        using id_type = typename calculator_type::id_t;
+        using node_type = typename calculator_type::node_type;
+        /// Smallest index type that can hold every next hop index of the table
+        using index_type = typename std::conditional<calculator_type::edge_capacity <= UINT8_MAX, uint8_t,
+                typename std::conditional<calculator_type::edge_capacity <= UINT16_MAX, uint16_t, uint32_t>::type>::type;
+        using table_type = route_table<id_type, calculator_type::node_capacity, calculator_type::edge_capacity, index_type>;
+
+    private:
+        struct pending_change {
+            node_type node;
+            bool removed;
+        };
+
+        struct stripe {
+            std::mutex mutex;
+            std::array<pending_change, stripe_capacity> changes = {};
+            size_t change_count = 0;
+        };
+
+        calculator_type calc;
+        std::array<stripe, stripe_count> stripes;
+        std::array<pending_change, stripe_capacity> batch = {};
+
+        std::array<table_type, 2> tables = {};
+        size_t published = 0;
+        mutable std::shared_mutex publish_mutex;
+
+        bool push(const pending_change &change) {
+            stripe &current = stripes[static_cast<size_t>(change.node.id) % stripe_count];
+            std::lock_guard<std::mutex> lock(current.mutex);
+
+            // A newer change for the same id replaces the pending one
+            for (size_t i = 0; i < current.change_count; i++) {
+                if (current.changes[i].node.id == change.node.id) {
+                    current.changes[i] = change;
+                    return true;
+                }
+            }
+            if (current.change_count == stripe_capacity) {
+                return false;
+            }
+            current.changes[current.change_count++] = change;
+            return true;
+        }
+
+    public:
+        /**
+         * \brief Create a concurrent calculator.
+         *
+         * @param source_id Identifier for the source node
+         */
+        explicit concurrent_calculator(const id_type &source_id) : calc(source_id) {}
+
+        /**
+         * \brief Queue replacing or inserting a node, see calculator::insert_replace(). Safe to call from any thread.
+         *
+         * @param node The node to insert/replace
+         * @return False if the node's stripe is full, call again after the next update()
+         */
+        bool insert_replace(const node_type &node) {
+            return push({node, false});
+        }
+
+        /**
+         * \brief Queue removing a node, see calculator::remove(). Safe to call from any thread.
+         *
+         * @param id Identifier for which to remove a node
+         * @return False if the node's stripe is full, call again after the next update()
+         */
+        bool remove(const id_type &id) {
+            return push({node_type(id), true});
+        }
+
+        /**
+         * \brief Apply all pending changes, recalculate and publish the new next hops.
+         *
+         * Should only be called from one thread at a time.
+         * @return True if there were any changes
+         */
+        bool update() {
+            bool changed = false;
+            for (stripe &current : stripes) {
+                size_t change_count = 0;
+                {
+                    std::lock_guard<std::mutex> lock(current.mutex);
+                    change_count = current.change_count;
+                    for (size_t i = 0; i < change_count; i++) {
+                        batch[i] = current.changes[i];
+                    }
+                    current.change_count = 0;
+                }
+
+                for (size_t i = 0; i < change_count; i++) {
+                    if (batch[i].removed) {
+                        calc.remove(batch[i].node.id);
+                    } else {
+                        calc.insert_replace(batch[i].node);
+                    }
+                }
+                changed |= change_count > 0;
+            }
+
+            if (!changed) {
+                return false;
+            }
+            calc.setup();
+            calc.loop();
+
+            // Only the SPF thread changes published, so reading it without lock is safe here
+            tables[1 - published] = table_type::compile(calc);
+            std::unique_lock<std::shared_mutex> lock(publish_mutex);
+            published = 1 - published;
+            return true;
+        }
+
+        /**
+         * \brief Get next hop for a given node id, as of the last update(). Safe to call from any thread.
+         *
+         * @param id ID to find next hop for
+         * @return The id of the next hop, or 0 if the node is unknown or unreachable
+         */
+        id_type get_next_hop(const id_type &id) const {
+            std::shared_lock<std::shared_mutex> lock(publish_mutex);
+            return tables[published].get_next_hop(id);
+        }
+
+        /**
+         * \brief Retrieve the calculator. Should only be used from the thread calling update().
+         *
+         * @return The calculator
+         */
+        const calculator_type &get_calculator() const {
+            return calc;
+        }
+    };
+
+    /**
+     * @}
+     */
+}
+
+#endif //IPASS_LINK_STATE_CONCURRENT_HPP
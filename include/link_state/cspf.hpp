@@ -0,0 +1,105 @@
+/*
+ *
+ * Copyright Niels Post 2019.
+ * Distributed under the Boost Software License, Version 1.0.
+ * (See accompanying file LICENSE_1_0.txt or copy at
+ * https://www.boost.org/LICENSE_1_0.txt)
+ *
+*/
+
+#ifndef IPASS_LINK_STATE_CSPF_HPP
+#define IPASS_LINK_STATE_CSPF_HPP
+
+#include <link_state/calculator.hpp>
+
+namespace link_state {
+
+    /**
+     * \addtogroup link_state
+     * @{
+     */
+
+    /**
+     * \brief Node extension holding traffic engineering attributes for each edge.
+     *
+     * Use as node_extension of the calculator to enable constrained shortest path queries.
+     * Indices should match those of node::edges.
+     * @tparam max_edges Maximum number of edges, should match the calculator's max_edges
+     * @tparam bandwidth_type Datatype for available link bandwidth
+     * @tparam affinity_type Datatype for the administrative group bitmask
+     */
+    template<size_t max_edges, typename bandwidth_type = uint32_t, typename affinity_type = uint32_t>
+    struct te_attributes {
+        /// Available bandwidth of each edge
+        std::array<bandwidth_type, max_edges> edge_bandwidths = {};
+        /// Administrative groups (affinity bitmask) of each edge
+        std::array<affinity_type, max_edges> edge_affinities = {};
+    };
+
+    /**
+     * \brief Constraints for a constrained shortest path query.
+     *
+     * @tparam bandwidth_type Datatype for link bandwidth, should match te_attributes
+     * @tparam affinity_type Datatype for the administrative group bitmask, should match te_attributes
+     */
+    template<typename bandwidth_type = uint32_t, typename affinity_type = uint32_t>
+    struct te_constraints {
+        /// Edges with less available bandwidth than this are pruned
+        bandwidth_type min_bandwidth = 0;
+        /// Edges carrying any of these administrative groups are pruned
+        affinity_type exclude_any = 0;
+        /// Edges not carrying all of these administrative groups are pruned
+        affinity_type include_all = 0;
+    };
+
+    /**
+     * \brief Edge view that prunes edges not matching a set of traffic engineering constraints.
+     *
+     * Pruning is done while relaxing, so a constrained run costs about the same as a normal run.
+     * @tparam bandwidth_type Datatype for link bandwidth
+     * @tparam affinity_type Datatype for the administrative group bitmask
+     */
+    template<typename bandwidth_type = uint32_t, typename affinity_type = uint32_t>
+    struct te_edge_view {
+        /// Constraints to check each edge against
+        te_constraints<bandwidth_type, affinity_type> constraints;
+
+        template<typename node_type, typename cost_type>
+        bool operator()(const size_t &, const node_type &from, const size_t &edge_index, const size_t &,
+                        cost_type &cost) const {
+            if (from.edge_bandwidths[edge_index] < constraints.min_bandwidth) {
+                return false;
+            }
+            if ((from.edge_affinities[edge_index] & constraints.exclude_any) != 0) {
+                return false;
+            }
+            if ((from.edge_affinities[edge_index] & constraints.include_all) != constraints.include_all) {
+                return false;
+            }
+            cost = from.edge_costs[edge_index];
+            return true;
+        }
+    };
+
+    /**
+     * \brief Calculate constrained shortest paths (CSPF) from the source node.
+     *
+     * Routing information in the calculator's nodes isn't changed, results are written into state.
+     * Use spf_state::get_path() to retrieve the explicit route to a destination.
+     * The calculator's node_extension should be (or derive from) link_state::te_attributes.
+     * @param calc Calculator holding the network graph
+     * @param constraints Constraints each edge in the path has to match
+     * @param state State to write the results into
+     */
+    template<typename calculator_type, typename bandwidth_type, typename affinity_type>
+    void cspf(calculator_type &calc, const te_constraints<bandwidth_type, affinity_type> &constraints,
+              typename calculator_type::state_type &state) {
+        calc.run(0, state, te_edge_view<bandwidth_type, affinity_type>{constraints});
+    }
+
+    /**
+     * @}
+     */
+}
+
+#endif //IPASS_LINK_STATE_CSPF_HPP
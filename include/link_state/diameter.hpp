@@ -0,0 +1,167 @@
+/*
+ *
+ * Copyright Niels Post 2019.
+ * Distributed under the Boost Software License, Version 1.0.
+ * (See accompanying file LICENSE_1_0.txt or copy at
+ * https://www.boost.org/LICENSE_1_0.txt)
+ *
+*/
+
+#ifndef IPASS_LINK_STATE_DIAMETER_HPP
+#define IPASS_LINK_STATE_DIAMETER_HPP
+
+#include <link_state/calculator.hpp>
+
+namespace link_state {
+
+    /**
+     * \addtogroup link_state
+     * @{
+     */
+
+    /**
+     * \brief Calculates the exact diameter and radius of a network, usually with only a handful of shortest path runs.
+     *
+     * The eccentricity of a node is its distance to the node furthest away, the diameter is the largest eccentricity and the radius the smallest.
+     * Instead of running from every node, lower and upper bounds on the eccentricity of every node are kept.
+     * A run from node v gives, for every node w: ecc(w) >= max(d(v, w), ecc(v) - d(v, w)) and ecc(w) <= ecc(v) + d(v, w).
+     * Nodes whose bounds can't change the diameter or radius anymore are dropped, and runs alternate between the remaining node with the
+     * highest upper bound and the one with the lowest lower bound, until no nodes remain (the BoundingDiameters algorithm).
+     *
+     * Only the nodes reachable from the source node (index 0) are considered. Links are assumed to be bidirectional with equal costs.
+     * @tparam calculator_type Calculator type holding the network graph
+     */
+    template<typename calculator_type>
+    class diameter {
+    public:
+        using cost_type = typename calculator_type::cost_t;
+        using state_type = typename calculator_type::state_type;
+
+        static_assert(calculator_type::algebra_type::additive,
+                      "Eccentricity bounds subtract distances, which requires an additive path algebra");
+
+    private:
+        state_type state = {};
+        std::array<cost_type, calculator_type::node_capacity> lower = {};
+        std::array<cost_type, calculator_type::node_capacity> upper = {};
+        std::array<bool, calculator_type::node_capacity> component = {};
+        std::array<bool, calculator_type::node_capacity> candidate = {};
+        cost_type diameter_value = 0;
+        cost_type radius_value = 0;
+        size_t run_count = 0;
+
+        void bound(const calculator_type &calc, const size_t &from) {
+            cost_type eccentricity = 0;
+            for (size_t i = 0; i < state.known_count; i++) {
+                if (state.distance[state.order[i]] > eccentricity) {
+                    eccentricity = state.distance[state.order[i]];
+                }
+            }
+
+            for (size_t i = 0; i < state.known_count; i++) {
+                const size_t &index = state.order[i];
+                const cost_type &distance = state.distance[index];
+                cost_type new_lower = eccentricity - distance > distance ? eccentricity - distance : distance;
+                if (new_lower > lower[index]) {
+                    lower[index] = new_lower;
+                }
+                if (upper[index] == calc.max_distance || eccentricity + distance < upper[index]) {
+                    upper[index] = eccentricity + distance;
+                }
+            }
+            lower[from] = upper[from] = eccentricity;
+            run_count++;
+        }
+
+    public:
+        /**
+         * \brief Calculate the diameter and radius.
+         *
+         * @param calc Calculator holding the network graph
+         * @param view Edge view deciding which edges are used and what they cost, use link_state::hop_edge_view for the hop diameter
+         */
+        template<typename edge_view = default_edge_view>
+        void calculate(const calculator_type &calc, const edge_view &view = {}) {
+            const size_t node_count = calc.get_node_count();
+            run_count = 0;
+            calc.run(0, state, view);
+            for (size_t i = 0; i < node_count; i++) {
+                component[i] = state.reachable(i);
+                candidate[i] = component[i];
+                lower[i] = 0;
+                upper[i] = calc.max_distance;
+            }
+            bound(calc, 0);
+
+            bool pick_highest = true;
+            while (true) {
+                diameter_value = 0;
+                radius_value = calc.max_distance;
+                for (size_t i = 0; i < node_count; i++) {
+                    if (component[i]) {
+                        if (lower[i] > diameter_value) {
+                            diameter_value = lower[i];
+                        }
+                        if (upper[i] < radius_value) {
+                            radius_value = upper[i];
+                        }
+                    }
+                }
+
+                size_t next = node_count;
+                for (size_t i = 0; i < node_count; i++) {
+                    if (!candidate[i]) {
+                        continue;
+                    }
+                    if (lower[i] == upper[i] || (upper[i] <= diameter_value && lower[i] >= radius_value)) {
+                        candidate[i] = false;
+                        continue;
+                    }
+                    if (next == node_count || (pick_highest ? upper[i] > upper[next] : lower[i] < lower[next])) {
+                        next = i;
+                    }
+                }
+                if (next == node_count) {
+                    return;
+                }
+
+                calc.run(next, state, view);
+                bound(calc, next);
+                pick_highest = !pick_highest;
+            }
+        }
+
+        /**
+         * \brief Retrieve the diameter found in the last calculation.
+         *
+         * @return Largest distance between any two nodes
+         */
+        cost_type get_diameter() const {
+            return diameter_value;
+        }
+
+        /**
+         * \brief Retrieve the radius found in the last calculation.
+         *
+         * @return Smallest eccentricity of any node
+         */
+        cost_type get_radius() const {
+            return radius_value;
+        }
+
+        /**
+         * \brief Retrieve the number of shortest path runs used by the last calculation.
+         *
+         * @return Number of runs
+         */
+        size_t get_run_count() const {
+            return run_count;
+        }
+    };
+
+    /**
+     * @}
+     */
+}
+
+#endif //IPASS_LINK_STATE_DIAMETER_HPP
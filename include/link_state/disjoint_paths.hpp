@@ -0,0 +1,314 @@
+/*
+ *
+ * Copyright Niels Post 2019.
+ * Distributed under the Boost Software License, Version 1.0.
+ * (See accompanying file LICENSE_1_0.txt or copy at
+ * https://www.boost.org/LICENSE_1_0.txt)
+ *
+*/
+
+#ifndef IPASS_LINK_STATE_DISJOINT_PATHS_HPP
+#define IPASS_LINK_STATE_DISJOINT_PATHS_HPP
+
+#include <link_state/calculator.hpp>
+
+namespace link_state {
+
+    /**
+     * \addtogroup link_state
+     * @{
+     */
+
+    /**
+     * \brief Node extension holding a shared risk link group for each edge.
+     *
+     * Edges in the same group (for example fibers in the same duct) fail together. Group 0 means the edge isn't in any group.
+     * Indices should match those of node::edges.
+     * @tparam max_edges Maximum number of edges, should match the calculator's max_edges
+     * @tparam group_type Datatype for group identifiers
+     */
+    template<size_t max_edges, typename group_type = uint32_t>
+    struct srlg_attributes {
+        /// Shared risk link group of each edge
+        std::array<group_type, max_edges> edge_groups = {};
+    };
+
+    /**
+     * \brief What the two paths calculated by link_state::disjoint_paths may not share.
+     */
+    enum class disjointness {
+        /// Paths don't share any link
+        link,
+        /// Paths don't share any node, except source and destination
+        node,
+        /// Paths don't share any link or shared risk link group (requires link_state::srlg_attributes)
+        srlg
+    };
+
+    /**
+     * \brief Calculates a pair of disjoint paths with minimum total cost (Suurballe's algorithm).
+     *
+     * The first run is a normal calculator::run() from the source.
+     * The second run uses costs reduced by the distances of the first run, with the edges of the first path reversed.
+     * Links are assumed to be bidirectional: the reverse of an edge on the first path is used as its reversed arc.
+     * Both paths are then untangled into two disjoint paths, so only two runs are needed.
+     *
+     * Finding the cheapest SRLG-disjoint pair is NP-hard, so disjointness::srlg doesn't reverse any edges.
+     * It excludes every group of the first path from the second run instead, which guarantees disjointness but not the minimum total cost.
+     * Paths are stored as lists of node indices, and are only valid as long as the calculator's nodes aren't changed.
+     * @tparam calculator_type Calculator type holding the network graph
+     */
+    template<typename calculator_type>
+    class disjoint_paths {
+    public:
+        using cost_type = typename calculator_type::cost_t;
+        using node_type = typename calculator_type::node_type;
+        using state_type = typename calculator_type::state_type;
+        using path_type = std::array<size_t, calculator_type::node_capacity>;
+        using algebra = typename calculator_type::algebra_type;
+
+        static_assert(algebra::additive,
+                      "Disjoint paths use reduced costs, which require an additive path algebra");
+
+    private:
+        static constexpr size_t no_node = state_type::no_node;
+        static constexpr size_t state_count = calculator_type::node_capacity * 2;
+        // no_node is a valid state index, so states use their own sentinel
+        static constexpr size_t no_state = state_count;
+
+        state_type tree = {};
+        std::array<size_t, calculator_type::node_capacity> first_next = {};
+
+        // Second run, every node has an "in" (index * 2) and "out" (index * 2 + 1) state to split nodes for node disjointness
+        std::array<cost_type, state_count> distance = {};
+        std::array<size_t, state_count> previous = {};
+        std::array<bool, state_count> known = {};
+
+        // Outgoing edges of both paths combined, used to untangle them
+        std::array<std::array<size_t, 2>, calculator_type::node_capacity> combined_next = {};
+
+        std::array<path_type, 2> paths = {};
+        std::array<size_t, 2> path_lengths = {};
+        cost_type total_cost = 0;
+
+        template<disjointness mode>
+        bool group_excluded(calculator_type &calc, const node_type &from, const size_t &edge_index,
+                            const size_t &path_length) const {
+            if constexpr (mode == disjointness::srlg) {
+                const auto &group = from.edge_groups[edge_index];
+                if (group == 0) {
+                    return false;
+                }
+                for (size_t i = 0; i + 1 < path_length; i++) {
+                    const node_type &path_node = calc.get_node(paths[0][i]);
+                    const auto &next_id = calc.get_node(paths[0][i + 1]).id;
+                    for (size_t j = 0; j < path_node.edge_count; j++) {
+                        if (path_node.edges[j] == next_id && path_node.edge_groups[j] == group) {
+                            return true;
+                        }
+                    }
+                }
+                return false;
+            } else {
+                (void) calc;
+                (void) from;
+                (void) edge_index;
+                (void) path_length;
+                return false;
+            }
+        }
+
+        void relax(const size_t &from_state, const size_t &to_state, const cost_type &cost) {
+            if (!known[to_state] && algebra::better(algebra::combine(distance[from_state], cost), distance[to_state])) {
+                distance[to_state] = algebra::combine(distance[from_state], cost);
+                previous[to_state] = from_state;
+            }
+        }
+
+        template<disjointness mode>
+        bool second_run(calculator_type &calc, const size_t &source_index, const size_t &destination_index) {
+            const size_t node_count = calc.get_node_count();
+            for (size_t i = 0; i < node_count * 2; i++) {
+                distance[i] = calc.max_distance;
+                previous[i] = no_state;
+                known[i] = false;
+            }
+            distance[source_index * 2 + 1] = algebra::source();
+
+            while (true) {
+                size_t current = no_state;
+                for (size_t i = 0; i < node_count * 2; i++) {
+                    if (!known[i] && algebra::better(distance[i], calc.max_distance) &&
+                        (current == no_state || algebra::better(distance[i], distance[current]))) {
+                        current = i;
+                    }
+                }
+                if (current == no_state) {
+                    return false;
+                }
+                known[current] = true;
+
+                const size_t current_index = current / 2;
+                if (current_index == destination_index) {
+                    return true;
+                }
+
+                const bool split = mode == disjointness::node && first_next[current_index] != no_node &&
+                                   current_index != source_index;
+                const bool in_state = (current % 2) == 0;
+                if (split && !in_state) {
+                    relax(current, current_index * 2, 0);
+                }
+
+                const node_type &current_node = calc.get_node(current_index);
+                for (size_t edge_id = 0; edge_id < current_node.edge_count; edge_id++) {
+                    size_t neighbour_index = calc.get_index_by_id(current_node.edges[edge_id]);
+                    if (neighbour_index == node_count || !tree.reachable(neighbour_index)) {
+                        continue;
+                    }
+                    if (first_next[current_index] == neighbour_index) {
+                        continue;
+                    }
+
+                    if (first_next[neighbour_index] == current_index) {
+                        // Reverse of an edge on the first path
+                        if (mode == disjointness::srlg) {
+                            continue;
+                        }
+                        relax(current, neighbour_index * 2 + 1, 0);
+                        continue;
+                    }
+
+                    if (split && in_state) {
+                        continue;
+                    }
+                    if (group_excluded<mode>(calc, current_node, edge_id, path_lengths[0])) {
+                        continue;
+                    }
+
+                    const bool enter_split = mode == disjointness::node && first_next[neighbour_index] != no_node &&
+                                             neighbour_index != source_index;
+                    relax(current, neighbour_index * 2 + (enter_split ? 0 : 1),
+                          algebra::combine(tree.distance[current_index], current_node.edge_costs[edge_id]) -
+                          tree.distance[neighbour_index]);
+                }
+            }
+        }
+
+        void untangle(const size_t &source_index, const size_t &destination_index) {
+            auto &next = combined_next;
+            for (size_t i = 0; i < calculator_type::node_capacity; i++) {
+                next[i] = {no_node, no_node};
+            }
+
+            // Edges of the first path, unless the second path uses them in reverse
+            for (size_t index = source_index; index != destination_index; index = first_next[index]) {
+                next[index][0] = first_next[index];
+            }
+            size_t state = destination_index * 2 + 1;
+            while (state / 2 != source_index) {
+                size_t from = previous[state] / 2;
+                size_t to = state / 2;
+                if (from != to) {
+                    if (first_next[to] == from) {
+                        next[to][0] = no_node;
+                    } else {
+                        next[from][1] = to;
+                    }
+                }
+                state = previous[state];
+            }
+
+            for (size_t path = 0; path < 2; path++) {
+                size_t length = 0;
+                size_t index = source_index;
+                paths[path][length++] = index;
+                while (index != destination_index) {
+                    size_t slot = next[index][0] != no_node ? 0 : 1;
+                    size_t following = next[index][slot];
+                    next[index][slot] = no_node;
+                    index = following;
+                    paths[path][length++] = index;
+                }
+                path_lengths[path] = length;
+            }
+        }
+
+    public:
+        /**
+         * \brief Calculate a pair of disjoint paths between two nodes.
+         *
+         * @tparam mode What the paths may not share
+         * @param calc Calculator holding the network graph
+         * @param source_index Node index of the source
+         * @param destination_index Node index of the destination
+         * @return True if a disjoint pair was found
+         */
+        template<disjointness mode = disjointness::link>
+        bool calculate(calculator_type &calc, const size_t &source_index, const size_t &destination_index) {
+            path_lengths = {0, 0};
+            if (source_index == destination_index) {
+                return false;
+            }
+
+            calc.run(source_index, tree);
+            if (!tree.reachable(destination_index)) {
+                return false;
+            }
+
+            for (size_t i = 0; i < calculator_type::node_capacity; i++) {
+                first_next[i] = no_node;
+            }
+            size_t first_length = tree.get_path(destination_index, paths[0]);
+            for (size_t i = 0; i + 1 < first_length; i++) {
+                first_next[paths[0][i]] = paths[0][i + 1];
+            }
+            path_lengths[0] = first_length;
+
+            if (!second_run<mode>(calc, source_index, destination_index)) {
+                path_lengths = {0, 0};
+                return false;
+            }
+
+            total_cost = algebra::combine(algebra::combine(tree.distance[destination_index], tree.distance[destination_index]),
+                                          distance[destination_index * 2 + 1]);
+            untangle(source_index, destination_index);
+            return true;
+        }
+
+        /**
+         * \brief Retrieve the summed cost of both paths found in the last calculation.
+         *
+         * @return Total cost
+         */
+        cost_type get_total_cost() const {
+            return total_cost;
+        }
+
+        /**
+         * \brief Retrieve one of the paths found in the last calculation.
+         *
+         * @param index Path index (0 or 1)
+         * @return Node indices of the path, source first
+         */
+        const path_type &get_path(const size_t &index) const {
+            return paths[index];
+        }
+
+        /**
+         * \brief Retrieve the number of nodes in one of the paths found in the last calculation.
+         *
+         * @param index Path index (0 or 1)
+         * @return Number of nodes in the path including source and destination, or 0 if no pair was found
+         */
+        size_t get_path_length(const size_t &index) const {
+            return path_lengths[index];
+        }
+    };
+
+    /**
+     * @}
+     */
+}
+
+#endif //IPASS_LINK_STATE_DISJOINT_PATHS_HPP
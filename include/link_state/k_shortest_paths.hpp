@@ -0,0 +1,281 @@
+/*
+ *
+ * Copyright Niels Post 2019.
+ * Distributed under the Boost Software License, Version 1.0.
+ * (See accompanying file LICENSE_1_0.txt or copy at
+ * https://www.boost.org/LICENSE_1_0.txt)
+ *
+*/
+
+#ifndef IPASS_LINK_STATE_K_SHORTEST_PATHS_HPP
+#define IPASS_LINK_STATE_K_SHORTEST_PATHS_HPP
+
+#include <link_state/calculator.hpp>
+
+namespace link_state {
+
+    /**
+     * \addtogroup link_state
+     * @{
+     */
+
+    /**
+     * \brief Calculates the k shortest loopless paths between two nodes (Yen's algorithm).
+     *
+     * The first path is taken from an existing shortest path tree of the source node.
+     * Following paths are found through spur runs: each is a full calculator::run() from the spur node, which stops as soon as the destination is known.
+     * The shortest path tree isn't updated incrementally between spur runs.
+     * Spur runs are only done from the point where a path deviated from its parent path (Lawler's improvement), since earlier spur nodes were already tried for the parent.
+     * All storage is fixed size, so memory use of a query is bounded by the template arguments.
+     * Paths are stored as lists of node indices, and are only valid as long as the calculator's nodes aren't changed.
+     * @tparam calculator_type Calculator type holding the network graph
+     * @tparam max_paths Maximum number of paths to calculate
+     * @tparam max_candidates Maximum number of candidate paths kept between iterations, at least max_paths so no path that is needed gets dropped
+     */
+    template<typename calculator_type, size_t max_paths, size_t max_candidates = max_paths>
+    class k_shortest_paths {
+        static_assert(max_candidates >= max_paths, "Fewer candidates than paths can drop candidates that are needed later");
+
+    public:
+        using cost_type = typename calculator_type::cost_t;
+        using node_type = typename calculator_type::node_type;
+        using state_type = typename calculator_type::state_type;
+        using algebra = typename calculator_type::algebra_type;
+
+        /**
+         * \brief A path through the network graph.
+         */
+        struct path_type {
+            /// Total cost of the path
+            cost_type cost = algebra::source();
+            /// Number of nodes in the path, including source and destination
+            size_t length = 0;
+            /// Index in path_type::hops where this path deviates from the path it was derived from
+            size_t deviation = 0;
+            /// Node indices of the path, source first
+            std::array<size_t, calculator_type::node_capacity> hops = {};
+        };
+
+    private:
+        std::array<path_type, max_paths> paths = {};
+        size_t path_count = 0;
+        std::array<path_type, max_candidates> candidates = {};
+        size_t candidate_count = 0;
+
+        state_type spur_state = {};
+        std::array<bool, calculator_type::node_capacity> blocked_nodes = {};
+        std::array<size_t, max_paths> blocked_next = {};
+        size_t blocked_next_count = 0;
+
+        /**
+         * \brief Edge view for spur runs, skipping root path nodes and edges used by earlier paths.
+         */
+        struct spur_view {
+            const k_shortest_paths &owner;
+            size_t spur_index;
+
+            bool operator()(const size_t &from_index, const node_type &from, const size_t &edge_index,
+                            const size_t &to_index, cost_type &cost) const {
+                if (owner.blocked_nodes[to_index]) {
+                    return false;
+                }
+                if (from_index == spur_index) {
+                    for (size_t i = 0; i < owner.blocked_next_count; i++) {
+                        if (owner.blocked_next[i] == to_index) {
+                            return false;
+                        }
+                    }
+                }
+                cost = from.edge_costs[edge_index];
+                return true;
+            }
+        };
+
+        static cost_type path_cost(calculator_type &calc, const path_type &path) {
+            cost_type cost = algebra::source();
+            for (size_t hop = 0; hop + 1 < path.length; hop++) {
+                const node_type &from = calc.get_node(path.hops[hop]);
+                const auto &to_id = calc.get_node(path.hops[hop + 1]).id;
+
+                // Use the best of any parallel edges
+                cost_type best = calc.max_distance;
+                for (size_t i = 0; i < from.edge_count; i++) {
+                    if (from.edges[i] == to_id && algebra::better(algebra::combine(cost, from.edge_costs[i]), best)) {
+                        best = algebra::combine(cost, from.edge_costs[i]);
+                    }
+                }
+                cost = best;
+            }
+            return cost;
+        }
+
+        static bool same_prefix(const path_type &a, const path_type &b, const size_t &length) {
+            if (a.length < length || b.length < length) {
+                return false;
+            }
+            for (size_t i = 0; i < length; i++) {
+                if (a.hops[i] != b.hops[i]) {
+                    return false;
+                }
+            }
+            return true;
+        }
+
+        bool is_known(const path_type &path) const {
+            for (size_t i = 0; i < path_count; i++) {
+                if (paths[i].length == path.length && same_prefix(paths[i], path, path.length)) {
+                    return true;
+                }
+            }
+            for (size_t i = 0; i < candidate_count; i++) {
+                if (candidates[i].length == path.length && same_prefix(candidates[i], path, path.length)) {
+                    return true;
+                }
+            }
+            return false;
+        }
+
+        static bool better(const path_type &a, const path_type &b) {
+            return algebra::better(a.cost, b.cost) || (a.cost == b.cost && a.length < b.length);
+        }
+
+        void add_candidate(const path_type &path) {
+            if (is_known(path)) {
+                return;
+            }
+            if (candidate_count < max_candidates) {
+                candidates[candidate_count++] = path;
+                return;
+            }
+
+            size_t worst = 0;
+            for (size_t i = 1; i < candidate_count; i++) {
+                if (better(candidates[worst], candidates[i])) {
+                    worst = i;
+                }
+            }
+            if (better(path, candidates[worst])) {
+                candidates[worst] = path;
+            }
+        }
+
+        void find_spurs(calculator_type &calc, const path_type &previous, const size_t &destination_index) {
+            for (size_t spur_position = previous.deviation; spur_position + 1 < previous.length; spur_position++) {
+                size_t spur_index = previous.hops[spur_position];
+
+                for (size_t i = 0; i < calc.get_node_count(); i++) {
+                    blocked_nodes[i] = false;
+                }
+                for (size_t i = 0; i < spur_position; i++) {
+                    blocked_nodes[previous.hops[i]] = true;
+                }
+
+                blocked_next_count = 0;
+                for (size_t i = 0; i < path_count; i++) {
+                    if (same_prefix(paths[i], previous, spur_position + 1) && paths[i].length > spur_position + 1) {
+                        blocked_next[blocked_next_count++] = paths[i].hops[spur_position + 1];
+                    }
+                }
+
+                calc.run(spur_index, spur_state, spur_view{*this, spur_index}, destination_index);
+
+                if (spur_state.reachable(destination_index)) {
+                    path_type candidate;
+                    for (size_t i = 0; i < spur_position; i++) {
+                        candidate.hops[i] = previous.hops[i];
+                    }
+
+                    std::array<size_t, calculator_type::node_capacity> spur_path;
+                    size_t spur_length = spur_state.get_path(destination_index, spur_path);
+                    for (size_t i = 0; i < spur_length; i++) {
+                        candidate.hops[spur_position + i] = spur_path[i];
+                    }
+                    candidate.length = spur_position + spur_length;
+                    candidate.cost = path_cost(calc, candidate);
+                    candidate.deviation = spur_position;
+                    add_candidate(candidate);
+                }
+
+            }
+        }
+
+    public:
+        /**
+         * \brief Calculate up to max_paths shortest loopless paths, reusing an existing shortest path tree.
+         *
+         * @param calc Calculator holding the network graph
+         * @param destination_index Node index of the destination
+         * @param source_tree Result of calculator::run() (with the default edge view) from the source node
+         * @return Number of paths found
+         */
+        size_t calculate(calculator_type &calc, const size_t &destination_index, const state_type &source_tree) {
+            path_count = 0;
+            candidate_count = 0;
+
+            path_type first;
+            first.length = source_tree.get_path(destination_index, first.hops);
+            if (first.length == 0) {
+                return 0;
+            }
+            first.cost = source_tree.distance[destination_index];
+            paths[path_count++] = first;
+
+            while (path_count < max_paths) {
+                find_spurs(calc, paths[path_count - 1], destination_index);
+
+                if (candidate_count == 0) {
+                    break;
+                }
+
+                size_t best = 0;
+                for (size_t i = 1; i < candidate_count; i++) {
+                    if (better(candidates[i], candidates[best])) {
+                        best = i;
+                    }
+                }
+                paths[path_count++] = candidates[best];
+                candidates[best] = candidates[--candidate_count];
+            }
+            return path_count;
+        }
+
+        /**
+         * \brief Calculate up to max_paths shortest loopless paths between two nodes.
+         *
+         * @param calc Calculator holding the network graph
+         * @param source_index Node index of the source
+         * @param destination_index Node index of the destination
+         * @return Number of paths found
+         */
+        size_t calculate(calculator_type &calc, const size_t &source_index, const size_t &destination_index) {
+            // The source tree is only read for the first path, before any spur run reuses the state
+            calc.run(source_index, spur_state);
+            return calculate(calc, destination_index, spur_state);
+        }
+
+        /**
+         * \brief Retrieve the number of paths found in the last calculation.
+         *
+         * @return Number of paths
+         */
+        size_t get_path_count() const {
+            return path_count;
+        }
+
+        /**
+         * \brief Retrieve a path found in the last calculation. Paths are ordered by cost, cheapest first.
+         *
+         * @param index Path index, should be lower than get_path_count()
+         * @return The path
+         */
+        const path_type &get_path(const size_t &index) const {
+            return paths[index];
+        }
+    };
+
+    /**
+     * @}
+     */
+}
+
+#endif //IPASS_LINK_STATE_K_SHORTEST_PATHS_HPP
@@ -0,0 +1,156 @@
+/*
+ *
+ * Copyright Niels Post 2019.
+ * Distributed under the Boost Software License, Version 1.0.
+ * (See accompanying file LICENSE_1_0.txt or copy at
+ * https://www.boost.org/LICENSE_1_0.txt)
+ *
+*/
+
+#ifndef IPASS_LINK_STATE_LINK_LOAD_HPP
+#define IPASS_LINK_STATE_LINK_LOAD_HPP
+
+#include <link_state/calculator.hpp>
+
+namespace link_state {
+
+    /**
+     * \addtogroup link_state
+     * @{
+     */
+
+    /**
+     * \brief Maps a traffic demand matrix onto shortest paths, to calculate the load on every edge.
+     *
+     * Traffic is forwarded the way routers using ECMP do: every node splits the traffic it forwards to a destination evenly
+     * over its equal cost next hops towards that destination. The split doesn't depend on how many paths lie behind each next hop.
+     * For each destination a single shortest path run is done from that destination. Nodes are then handled furthest first,
+     * each adding its own demand to the traffic it received and passing it on to its next hops, so each destination costs O(N + E)
+     * on top of its run instead of walking every path.
+     * Links are assumed to be bidirectional with equal costs, so the run from the destination gives the distance of every node to it.
+     * Edge costs should be positive.
+     *
+     * Destinations can be split over multiple link_load objects (for example one per thread, see parallel.hpp) and combined with merge().
+     * Loads are indexed by node index and edge index, so they're only valid as long as the calculator's nodes aren't changed.
+     * @tparam calculator_type Calculator type holding the network graph
+     * @tparam load_type Datatype for demand and load, should be able to hold fractions
+     */
+    template<typename calculator_type, typename load_type = double>
+    class link_load {
+    public:
+        using node_type = typename calculator_type::node_type;
+        using state_type = typename calculator_type::state_type;
+
+    private:
+        state_type state = {};
+        std::array<load_type, calculator_type::node_capacity> flow = {};
+        std::array<std::array<load_type, calculator_type::edge_capacity>, calculator_type::node_capacity> loads = {};
+
+        // Is an edge of a node a next hop towards the destination of the last run
+        bool is_next_hop(const calculator_type &calc, const node_type &from, const size_t &from_index,
+                         const size_t &edge_index, size_t &to_index) const {
+            to_index = calc.get_index_by_id(from.edges[edge_index]);
+            return to_index != calc.get_node_count() && state.reachable(to_index) &&
+                   calculator_type::algebra_type::combine(state.distance[to_index], from.edge_costs[edge_index]) ==
+                   state.distance[from_index];
+        }
+
+    public:
+        /**
+         * \brief Set all loads to zero.
+         */
+        void reset() {
+            for (auto &node_loads : loads) {
+                node_loads.fill(0);
+            }
+        }
+
+        /**
+         * \brief Add the load of all traffic to a range of destinations.
+         *
+         * The demand is called as demand(source_index, destination_index), and should return the traffic from source to destination.
+         * @param calc Calculator holding the network graph
+         * @param demand Demand matrix
+         * @param first_destination Index of the first destination node
+         * @param last_destination Index after the last destination node
+         */
+        template<typename demand_type>
+        void evaluate(const calculator_type &calc, const demand_type &demand, const size_t &first_destination,
+                      const size_t &last_destination) {
+            for (size_t destination = first_destination; destination < last_destination; destination++) {
+                calc.run(destination, state);
+
+                for (size_t position = state.known_count; position > 1; position--) {
+                    const size_t from_index = state.order[position - 1];
+                    const node_type &from = calc.get_node(from_index);
+                    size_t to_index = 0;
+
+                    size_t next_hop_count = 0;
+                    for (size_t edge_id = 0; edge_id < from.edge_count; edge_id++) {
+                        if (is_next_hop(calc, from, from_index, edge_id, to_index)) {
+                            next_hop_count++;
+                        }
+                    }
+                    if (next_hop_count == 0) {
+                        continue;
+                    }
+
+                    // flow already holds the traffic received from nodes further away
+                    load_type share = (flow[from_index] + demand(from_index, destination)) / static_cast<load_type>(next_hop_count);
+                    for (size_t edge_id = 0; edge_id < from.edge_count; edge_id++) {
+                        if (is_next_hop(calc, from, from_index, edge_id, to_index)) {
+                            loads[from_index][edge_id] += share;
+                            flow[to_index] += share;
+                        }
+                    }
+                }
+
+                for (size_t position = 0; position < state.known_count; position++) {
+                    flow[state.order[position]] = 0;
+                }
+            }
+        }
+
+        /**
+         * \brief Calculate the load of all traffic in the network.
+         *
+         * @param calc Calculator holding the network graph
+         * @param demand Demand matrix, see evaluate(const calculator_type &, const demand_type &, const size_t &, const size_t &)
+         */
+        template<typename demand_type>
+        void evaluate(const calculator_type &calc, const demand_type &demand) {
+            reset();
+            evaluate(calc, demand, 0, calc.get_node_count());
+        }
+
+        /**
+         * \brief Add the loads calculated by another link_load object.
+         *
+         * @param other Object to add the loads of
+         */
+        void merge(const link_load &other) {
+            for (size_t i = 0; i < calculator_type::node_capacity; i++) {
+                for (size_t j = 0; j < calculator_type::edge_capacity; j++) {
+                    loads[i][j] += other.loads[i][j];
+                }
+            }
+        }
+
+        /**
+         * \brief Retrieve the load on an edge.
+         *
+         * @param node_index Index of the node the edge starts at
+         * @param edge_index Index of the edge in node::edges
+         * @return Load on the edge
+         */
+        const load_type &get_load(const size_t &node_index, const size_t &edge_index) const {
+            return loads[node_index][edge_index];
+        }
+    };
+
+    /**
+     * @}
+     */
+}
+
+#endif //IPASS_LINK_STATE_LINK_LOAD_HPP
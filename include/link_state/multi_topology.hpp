@@ -0,0 +1,118 @@
+/*
+ *
+ * Copyright Niels Post 2019.
+ * Distributed under the Boost Software License, Version 1.0.
+ * (See accompanying file LICENSE_1_0.txt or copy at
+ * https://www.boost.org/LICENSE_1_0.txt)
+ *
+*/
+
+#ifndef IPASS_LINK_STATE_MULTI_TOPOLOGY_HPP
+#define IPASS_LINK_STATE_MULTI_TOPOLOGY_HPP
+
+#include <link_state/calculator.hpp>
+
+namespace link_state {
+
+    /**
+     * \addtogroup link_state
+     * @{
+     */
+
+    /**
+     * \brief Node extension holding extra cost planes for each edge.
+     *
+     * All planes share the node's edges, so a topology with multiple metrics (latency, IGP cost, TE cost) is only stored once.
+     * Plane 0 is node::edge_costs, plane p (p > 0) is cost_planes::edge_cost_planes[p - 1].
+     * Indices should match those of node::edges.
+     * @tparam cost_type Datatype for edge costs, should match the calculator's cost_type
+     * @tparam max_edges Maximum number of edges, should match the calculator's max_edges
+     * @tparam extra_planes Number of planes besides node::edge_costs
+     */
+    template<typename cost_type, size_t max_edges, size_t extra_planes>
+    struct cost_planes {
+        /// Costs of each edge in the extra planes
+        std::array<std::array<cost_type, max_edges>, extra_planes> edge_cost_planes = {};
+
+        /**
+         * \brief Retrieve the cost of an edge in a plane.
+         *
+         * @param edge_costs The node's normal edge costs (plane 0)
+         * @param plane Plane index
+         * @param edge_index Index of the edge in node::edges
+         * @return Cost of the edge
+         */
+        const cost_type &
+        plane_cost(const std::array<cost_type, max_edges> &edge_costs, const size_t &plane,
+                   const size_t &edge_index) const {
+            return plane == 0 ? edge_costs[edge_index] : edge_cost_planes[plane - 1][edge_index];
+        }
+    };
+
+    /**
+     * \brief Edge view using the costs of a single cost plane.
+     *
+     * Use with calculator::run() to calculate shortest paths for one plane.
+     */
+    struct plane_edge_view {
+        /// Plane to use costs from
+        size_t plane;
+
+        template<typename node_type, typename cost_type>
+        bool operator()(const size_t &, const node_type &from, const size_t &edge_index, const size_t &,
+                        cost_type &cost) const {
+            cost = from.plane_cost(from.edge_costs, plane, edge_index);
+            return true;
+        }
+    };
+
+    /**
+     * \brief Calculates shortest paths for several cost planes at once.
+     *
+     * Every plane is a calculator::run() with a link_state::plane_edge_view, so all planes share the calculator's edges
+     * and tie-breaking, and only the results are stored per plane.
+     * The calculator's node_extension should be (or derive from) link_state::cost_planes.
+     * @tparam calculator_type Calculator type holding the network graph
+     * @tparam plane_count Number of planes to calculate, including plane 0
+     */
+    template<typename calculator_type, size_t plane_count>
+    class multi_topology {
+    public:
+        using cost_type = typename calculator_type::cost_t;
+        using node_type = typename calculator_type::node_type;
+        using state_type = typename calculator_type::state_type;
+        using algebra = typename calculator_type::algebra_type;
+
+    private:
+        std::array<state_type, plane_count> states = {};
+
+    public:
+        /**
+         * \brief Calculate shortest paths for all planes.
+         *
+         * @param calc Calculator holding the network graph
+         * @param source_index Index of the node to start from
+         */
+        void run(const calculator_type &calc, const size_t &source_index = 0) {
+            for (size_t plane = 0; plane < plane_count; plane++) {
+                calc.run(source_index, states[plane], plane_edge_view{plane});
+            }
+        }
+
+        /**
+         * \brief Retrieve the result of a plane.
+         *
+         * @param plane Plane index
+         * @return State holding the shortest paths of the plane
+         */
+        const state_type &get_state(const size_t &plane) const {
+            return states[plane];
+        }
+    };
+
+    /**
+     * @}
+     */
+}
+
+#endif //IPASS_LINK_STATE_MULTI_TOPOLOGY_HPP
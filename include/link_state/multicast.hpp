@@ -0,0 +1,285 @@
+/*
+ *
+ * Copyright Niels Post 2019.
+ * Distributed under the Boost Software License, Version 1.0.
+ * (See accompanying file LICENSE_1_0.txt or copy at
+ * https://www.boost.org/LICENSE_1_0.txt)
+ *
+*/
+
+#ifndef IPASS_LINK_STATE_MULTICAST_HPP
+#define IPASS_LINK_STATE_MULTICAST_HPP
+
+#include <link_state/calculator.hpp>
+
+namespace link_state {
+
+    /**
+     * \addtogroup link_state
+     * @{
+     */
+
+    /**
+     * \brief Calculates multicast distribution trees: source trees pruned to a receiver set, and approximate Steiner (shared) trees.
+     *
+     * A source tree is the shortest path tree of the source, with only the branches leading to receivers kept.
+     * A shared tree connects a set of terminals at (approximately) minimum total cost, using the KMB algorithm:
+     * shortest paths between all terminals (one run per terminal, done one after another on the calling thread), a minimum spanning tree over those distances,
+     * a minimum spanning tree over the nodes on the chosen paths, and finally pruning leaves that aren't terminals.
+     * The result is at most 2 times as expensive as the optimal Steiner tree. Links are assumed to be bidirectional with equal costs.
+     *
+     * Trees are stored as a parent node index for each node in the tree, and are only valid as long as the calculator's nodes aren't changed.
+     * @tparam calculator_type Calculator type holding the network graph
+     * @tparam max_terminals Maximum number of terminals in a shared tree
+     */
+    template<typename calculator_type, size_t max_terminals>
+    class multicast_tree {
+    public:
+        using cost_type = typename calculator_type::cost_t;
+        using node_type = typename calculator_type::node_type;
+        using state_type = typename calculator_type::state_type;
+        using algebra = typename calculator_type::algebra_type;
+
+        /// Parent index of nodes that aren't in the tree
+        static constexpr size_t no_node = state_type::no_node;
+
+        static_assert(algebra::additive, "Tree costs are sums of edge costs, which require an additive path algebra");
+
+    private:
+        std::array<state_type, max_terminals> states = {};
+
+        std::array<size_t, calculator_type::node_capacity> parents = {};
+        std::array<cost_type, calculator_type::node_capacity> edge_costs = {};
+        std::array<size_t, calculator_type::node_capacity> child_counts = {};
+        std::array<bool, calculator_type::node_capacity> terminal = {};
+        std::array<bool, calculator_type::node_capacity> in_subgraph = {};
+        std::array<bool, calculator_type::node_capacity> added = {};
+        size_t root = 0;
+        cost_type total_cost = 0;
+
+        void clear(const calculator_type &calc) {
+            for (size_t i = 0; i < calc.get_node_count(); i++) {
+                parents[i] = no_node;
+                terminal[i] = false;
+                in_subgraph[i] = false;
+            }
+            total_cost = 0;
+        }
+
+        static bool find_edge_cost(const calculator_type &calc, const size_t &from, const size_t &to, cost_type &cost) {
+            const node_type &from_node = calc.get_node(from);
+            bool found = false;
+            for (size_t edge_id = 0; edge_id < from_node.edge_count; edge_id++) {
+                if (from_node.edges[edge_id] == calc.get_node(to).id &&
+                    (!found || algebra::better(from_node.edge_costs[edge_id], cost))) {
+                    cost = from_node.edge_costs[edge_id];
+                    found = true;
+                }
+            }
+            return found;
+        }
+
+        // Minimum spanning tree (Prim) over the nodes in the subgraph, rooted at root
+        void spanning_tree(const calculator_type &calc) {
+            const size_t node_count = calc.get_node_count();
+            for (size_t i = 0; i < node_count; i++) {
+                added[i] = false;
+                parents[i] = no_node;
+                edge_costs[i] = calc.max_distance;
+            }
+            edge_costs[root] = algebra::source();
+            parents[root] = root;
+
+            while (true) {
+                size_t current = node_count;
+                for (size_t i = 0; i < node_count; i++) {
+                    if (in_subgraph[i] && !added[i] && parents[i] != no_node &&
+                        (current == node_count || algebra::better(edge_costs[i], edge_costs[current]))) {
+                        current = i;
+                    }
+                }
+                if (current == node_count) {
+                    return;
+                }
+                added[current] = true;
+
+                const node_type &current_node = calc.get_node(current);
+                for (size_t edge_id = 0; edge_id < current_node.edge_count; edge_id++) {
+                    size_t neighbour_index = calc.get_index_by_id(current_node.edges[edge_id]);
+                    if (neighbour_index == node_count || !in_subgraph[neighbour_index] || added[neighbour_index]) {
+                        continue;
+                    }
+                    if (parents[neighbour_index] == no_node ||
+                        algebra::better(current_node.edge_costs[edge_id], edge_costs[neighbour_index])) {
+                        parents[neighbour_index] = current;
+                        edge_costs[neighbour_index] = current_node.edge_costs[edge_id];
+                    }
+                }
+            }
+        }
+
+        // Repeatedly remove leaves that aren't terminals, then sum the costs of the remaining edges
+        void prune(const calculator_type &calc) {
+            const size_t node_count = calc.get_node_count();
+            for (size_t i = 0; i < node_count; i++) {
+                child_counts[i] = 0;
+            }
+            for (size_t i = 0; i < node_count; i++) {
+                if (parents[i] != no_node && i != root) {
+                    child_counts[parents[i]]++;
+                }
+            }
+
+            for (size_t i = 0; i < node_count; i++) {
+                size_t leaf = i;
+                while (leaf != root && parents[leaf] != no_node && child_counts[leaf] == 0 && !terminal[leaf]) {
+                    size_t parent = parents[leaf];
+                    parents[leaf] = no_node;
+                    child_counts[parent]--;
+                    leaf = parent;
+                }
+            }
+
+            total_cost = algebra::source();
+            for (size_t i = 0; i < node_count; i++) {
+                if (parents[i] != no_node && i != root) {
+                    total_cost = algebra::combine(total_cost, edge_costs[i]);
+                }
+            }
+        }
+
+    public:
+        /**
+         * \brief Calculate the shortest path tree of a source, pruned to the branches leading to the receivers.
+         *
+         * Each receiver's path is followed back until it reaches a node that is already in the tree, so every node is visited once.
+         * @param calc Calculator holding the network graph
+         * @param source_index Index of the source node
+         * @param receivers Indices of the receivers
+         * @param receiver_count Number of receivers
+         * @return False if any receiver is unreachable, the tree then only holds the reachable receivers
+         */
+        bool source_tree(const calculator_type &calc, const size_t &source_index, const size_t *receivers,
+                         const size_t &receiver_count) {
+            clear(calc);
+            root = source_index;
+            state_type &state = states[0];
+            calc.run(source_index, state);
+            parents[root] = root;
+
+            bool all_reachable = true;
+            for (size_t i = 0; i < receiver_count; i++) {
+                if (!state.reachable(receivers[i])) {
+                    all_reachable = false;
+                    continue;
+                }
+                for (size_t index = receivers[i]; parents[index] == no_node; index = state.previous[index]) {
+                    parents[index] = state.previous[index];
+                    find_edge_cost(calc, state.previous[index], index, edge_costs[index]);
+                    total_cost = algebra::combine(total_cost, edge_costs[index]);
+                }
+            }
+            return all_reachable;
+        }
+
+        /**
+         * \brief Calculate an approximate minimum cost tree connecting all terminals (KMB algorithm).
+         *
+         * The tree is rooted at the first terminal.
+         * @param calc Calculator holding the network graph
+         * @param terminals Indices of the terminals
+         * @param terminal_count Number of terminals (at most max_terminals)
+         * @return False if there are too many terminals, or they aren't all connected
+         */
+        bool steiner_tree(const calculator_type &calc, const size_t *terminals, const size_t &terminal_count) {
+            clear(calc);
+            if (terminal_count == 0 || terminal_count > max_terminals) {
+                return false;
+            }
+            root = terminals[0];
+
+            for (size_t t = 0; t < terminal_count; t++) {
+                terminal[terminals[t]] = true;
+                calc.run(terminals[t], states[t]);
+            }
+
+            // Minimum spanning tree over the terminal distances, each chosen terminal pair marks the nodes on its shortest path
+            std::array<bool, max_terminals> connected = {};
+            std::array<size_t, max_terminals> closest = {};
+            connected[0] = true;
+            in_subgraph[root] = true;
+            for (size_t t = 1; t < terminal_count; t++) {
+                closest[t] = 0;
+            }
+            for (size_t connected_count = 1; connected_count < terminal_count; connected_count++) {
+                size_t next = terminal_count;
+                for (size_t t = 1; t < terminal_count; t++) {
+                    const state_type &from = states[closest[t]];
+                    if (!connected[t] && from.reachable(terminals[t]) &&
+                        (next == terminal_count ||
+                         algebra::better(from.distance[terminals[t]], states[closest[next]].distance[terminals[next]]))) {
+                        next = t;
+                    }
+                }
+                if (next == terminal_count) {
+                    clear(calc);
+                    return false;
+                }
+                connected[next] = true;
+
+                const state_type &from = states[closest[next]];
+                for (size_t index = terminals[next]; index != from.source; index = from.previous[index]) {
+                    in_subgraph[index] = true;
+                }
+
+                for (size_t t = 1; t < terminal_count; t++) {
+                    if (!connected[t] && states[next].reachable(terminals[t]) &&
+                        (!states[closest[t]].reachable(terminals[t]) ||
+                         algebra::better(states[next].distance[terminals[t]],
+                                         states[closest[t]].distance[terminals[t]]))) {
+                        closest[t] = next;
+                    }
+                }
+            }
+
+            spanning_tree(calc);
+            prune(calc);
+            return true;
+        }
+
+        /**
+         * \brief Retrieve the parent of a node in the last calculated tree.
+         *
+         * @param index Node index
+         * @return Index of the parent node, the index itself for the root, or no_node if the node isn't in the tree
+         */
+        size_t get_parent(const size_t &index) const {
+            return parents[index];
+        }
+
+        /**
+         * \brief Check if a node is part of the last calculated tree.
+         *
+         * @param index Node index
+         * @return True if the node is in the tree
+         */
+        bool in_tree(const size_t &index) const {
+            return parents[index] != no_node;
+        }
+
+        /**
+         * \brief Retrieve the summed cost of all edges in the last calculated tree.
+         *
+         * @return Total cost
+         */
+        cost_type get_total_cost() const {
+            return total_cost;
+        }
+    };
+
+    /**
+     * @}
+     */
+}
+
+#endif //IPASS_LINK_STATE_MULTICAST_HPP
@@ -20,6 +20,32 @@ namespace link_state {
      * @{
      */
 
+    /**
+     * \brief Empty node extension.
+     *
+     * Used as default node extension, so nodes without extra edge attributes don't take up any extra memory.
+     */
+    struct no_extension {
+    };
+
+    /**
+     * \brief Hop count of a node, used by the calculator to break ties between equal cost paths.
+     *
+     * @tparam hop_type Datatype for hop counts, or void to store no hop count at all
+     */
+    template<typename hop_type>
+    struct hop_counter {
+        /// Number of hops in the current path from the source node to this node
+        hop_type hop_count = 0;
+    };
+
+    /**
+     * \brief Empty hop count, for calculators that don't break ties on hop count.
+     */
+    template<>
+    struct hop_counter<void> {
+    };
+
     /**
      * \brief Link_state network node.
      *
@@ -28,15 +54,17 @@ namespace link_state {
      * If shortest_path_known is false, any path-related information shouldn't be trusted, since the link state algorithm hasn't been (successfully) run on this node.
      * All template arguments used should match those of the used link_state::calculator
      * @tparam id_type Datatype for node identifiers
-     * @tparam cost_type  Datatype for edge costs,  make sure this is large enough to contain summed distances.
+     * @tparam cost_type  Datatype for edge costs,  make sure this is large enough to contain summed distances (unless the calculator uses link_state::saturating_shortest_path).
      * @tparam max_edges Maximum number of edges for this node. This should be kept as low as possible, since it saves memory
+     * @tparam extension Optional base class holding extra per-edge attribute arrays (for example link_state::te_attributes). Its indices should match those of node::edges
+     * @tparam hop_type Datatype for the hop count used to break ties between equal cost paths, void (the default) stores none, see link_state::hop_counter
      */
-    template<typename id_type, typename cost_type, size_t max_edges>
-    struct node {
+    template<typename id_type, typename cost_type, size_t max_edges, typename extension = no_extension, typename hop_type = void>
+    struct node : public extension, public hop_counter<hop_type> {
         /// Node identifier
         id_type id;
         /// Identifiers of nodes connected to this node
-        std::array<id_type, max_edges> edges;
+        std::array<id_type, max_edges> edges = {};
         /// Costs of all connections to this node (make sure the indices match those of node::edges
         std::array<cost_type, max_edges> edge_costs = {1};
         /// Current amount of connections
@@ -53,14 +81,14 @@ namespace link_state {
          *
          * @param id Identifier of the link_state node
          */
-        node(id_type id) : id(id) {}
+        constexpr node(id_type id) : id(id) {}
 
         /**
          * \brief Create a default link_state node.
          *
          * Sets the id to zero, and all other values to their defaults
          */
-        node() : id(0) {}
+        constexpr node() : id(0) {}
 
         /**
          * \brief Create a link_state node.
@@ -72,7 +100,7 @@ namespace link_state {
          *
          *
          */
-        node(id_type id, const std::array<id_type, max_edges> edges,
+        constexpr node(id_type id, const std::array<id_type, max_edges> edges,
              const std::array<cost_type, max_edges> edgecosts
         ) : id(id), edges(edges), edge_costs(edgecosts) {
             for (const id_type &edge_id : edges) {
@@ -92,8 +120,10 @@ namespace link_state {
          * @param id Identifier of node
          * @param edges The currently known edges
          */
-        node(id_type id, const std::array<id_type, max_edges> &edges) : node(id, edges, {0}) {
-            edge_costs.fill(1);
+        constexpr node(id_type id, const std::array<id_type, max_edges> &edges) : node(id, edges, {0}) {
+            for (cost_type &edge_cost : edge_costs) {
+                edge_cost = 1;
+            }
         }
 
     };
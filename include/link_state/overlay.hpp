@@ -0,0 +1,360 @@
+/*
+ *
+ * Copyright Niels Post 2019.
+ * Distributed under the Boost Software License, Version 1.0.
+ * (See accompanying file LICENSE_1_0.txt or copy at
+ * https://www.boost.org/LICENSE_1_0.txt)
+ *
+*/
+
+#ifndef IPASS_LINK_STATE_OVERLAY_HPP
+#define IPASS_LINK_STATE_OVERLAY_HPP
+
+#include <link_state/calculator.hpp>
+
+namespace link_state {
+
+    /**
+     * \addtogroup link_state
+     * @{
+     */
+
+    /**
+     * \brief Partitioned overlay graph for fast recalculation (customizable route planning).
+     *
+     * The network is split into cells. Nodes with an edge to another cell are boundary nodes.
+     * For every boundary node, the distances to all nodes inside its own cell are stored (customization).
+     * A query then only does a run inside the source's cell, followed by a run over the boundary nodes (the overlay),
+     * and the distance to any node is the best overlay distance of a boundary node in its cell plus the stored in-cell distance.
+     * When edge costs inside a cell change, only that cell has to be customized again.
+     *
+     * Partitioning uses farthest-first seeds with nearest-seed assignment, followed by a greedy boundary refinement pass.
+     * This is a lightweight stand-in for multilevel partitioning, which doesn't need any dynamic memory.
+     * Partitioning and customization are only valid as long as no nodes are inserted or removed, call partition() again after that.
+     * Requires an additive path algebra.
+     * @tparam calculator_type Calculator type holding the network graph
+     * @tparam max_cells Maximum number of cells
+     * @tparam max_boundary Maximum number of boundary nodes
+     */
+    template<typename calculator_type, size_t max_cells, size_t max_boundary>
+    class overlay {
+    public:
+        using cost_type = typename calculator_type::cost_t;
+        using node_type = typename calculator_type::node_type;
+        using state_type = typename calculator_type::state_type;
+        using algebra = typename calculator_type::algebra_type;
+
+        static_assert(algebra::additive, "The overlay adds distances of path parts, which requires an additive path algebra");
+
+    private:
+        static constexpr size_t no_node = state_type::no_node;
+        static constexpr size_t node_capacity = calculator_type::node_capacity;
+
+        std::array<size_t, node_capacity> cells = {};
+        std::array<size_t, max_cells> cell_sizes = {};
+        size_t cell_count = 0;
+
+        std::array<cost_type, node_capacity> seed_distances = {};
+
+        std::array<size_t, max_boundary> boundary = {};
+        std::array<size_t, node_capacity> boundary_slots = {};
+        size_t boundary_count = 0;
+        bool boundary_overflow = false;
+        std::array<std::array<cost_type, node_capacity>, max_boundary> cell_distances = {};
+
+        state_type local = {};
+        std::array<cost_type, max_boundary> overlay_distances = {};
+        std::array<size_t, max_boundary> first_hops = {};
+        std::array<bool, max_boundary> overlay_known = {};
+
+        /**
+         * \brief Edge view that only uses edges inside a single cell.
+         */
+        struct cell_view {
+            const overlay &owner;
+            size_t cell;
+
+            bool operator()(const size_t &, const node_type &from, const size_t &edge_index, const size_t &to_index,
+                            cost_type &cost) const {
+                if (owner.cells[to_index] != cell) {
+                    return false;
+                }
+                cost = from.edge_costs[edge_index];
+                return true;
+            }
+        };
+
+        void refine(const calculator_type &calc, const size_t &max_cell_size) {
+            for (size_t i = 0; i < calc.get_node_count(); i++) {
+                std::array<size_t, max_cells> neighbour_cells = {};
+                const node_type &current = calc.get_node(i);
+                for (size_t edge_id = 0; edge_id < current.edge_count; edge_id++) {
+                    size_t neighbour = calc.get_index_by_id(current.edges[edge_id]);
+                    if (neighbour != calc.get_node_count()) {
+                        neighbour_cells[cells[neighbour]]++;
+                    }
+                }
+
+                size_t best = cells[i];
+                for (size_t cell = 0; cell < cell_count; cell++) {
+                    if (neighbour_cells[cell] > neighbour_cells[best] && cell_sizes[cell] < max_cell_size) {
+                        best = cell;
+                    }
+                }
+                if (best != cells[i] && cell_sizes[cells[i]] > 1) {
+                    cell_sizes[cells[i]]--;
+                    cell_sizes[best]++;
+                    cells[i] = best;
+                }
+            }
+        }
+
+        void find_boundary(const calculator_type &calc) {
+            boundary_count = 0;
+            boundary_overflow = false;
+            for (size_t i = 0; i < node_capacity; i++) {
+                boundary_slots[i] = no_node;
+            }
+
+            for (size_t i = 0; i < calc.get_node_count(); i++) {
+                const node_type &current = calc.get_node(i);
+                for (size_t edge_id = 0; edge_id < current.edge_count; edge_id++) {
+                    size_t neighbour = calc.get_index_by_id(current.edges[edge_id]);
+                    if (neighbour == calc.get_node_count() || cells[neighbour] == cells[i]) {
+                        continue;
+                    }
+                    add_boundary(i);
+                    add_boundary(neighbour);
+                }
+            }
+        }
+
+        void add_boundary(const size_t &index) {
+            if (boundary_slots[index] != no_node) {
+                return;
+            }
+            if (boundary_count == max_boundary) {
+                boundary_overflow = true;
+                return;
+            }
+            boundary_slots[index] = boundary_count;
+            boundary[boundary_count++] = index;
+        }
+
+    public:
+        /**
+         * \brief Split the network into cells, and customize all cells.
+         *
+         * @param calc Calculator holding the network graph
+         * @param requested_cells Number of cells to create (at most max_cells)
+         * @return False if there are more boundary nodes than max_boundary, in which case the overlay can't be used
+         */
+        bool partition(const calculator_type &calc, const size_t &requested_cells) {
+            const size_t node_count = calc.get_node_count();
+            cell_count = requested_cells < node_count ? requested_cells : node_count;
+            cell_sizes = {};
+
+            for (size_t i = 0; i < node_count; i++) {
+                seed_distances[i] = calc.max_distance;
+                cells[i] = 0;
+            }
+
+            size_t seed = 0;
+            for (size_t cell = 0; cell < cell_count; cell++) {
+                calc.run(seed, local, hop_edge_view{});
+                for (size_t i = 0; i < node_count; i++) {
+                    if (algebra::better(local.distance[i], seed_distances[i])) {
+                        seed_distances[i] = local.distance[i];
+                        cells[i] = cell;
+                    }
+                }
+
+                // Next seed is the reachable node farthest away from all seeds so far
+                for (size_t i = 0; i < node_count; i++) {
+                    if (seed_distances[i] != calc.max_distance &&
+                        algebra::better(seed_distances[seed], seed_distances[i])) {
+                        seed = i;
+                    }
+                }
+            }
+
+            for (size_t i = 0; i < node_count; i++) {
+                cell_sizes[cells[i]]++;
+            }
+            refine(calc, node_count * 5 / (cell_count * 4) + 1);
+
+            return customize(calc);
+        }
+
+        /**
+         * \brief Recalculate the boundary nodes and the in-cell distances of all cells.
+         *
+         * @param calc Calculator holding the network graph
+         * @return False if there are more boundary nodes than max_boundary
+         */
+        bool customize(const calculator_type &calc) {
+            find_boundary(calc);
+            for (size_t cell = 0; cell < cell_count; cell++) {
+                customize_cell(calc, cell);
+            }
+            return !boundary_overflow;
+        }
+
+        /**
+         * \brief Recalculate the in-cell distances of a single cell, after edge costs inside it changed.
+         *
+         * @param calc Calculator holding the network graph
+         * @param cell Cell to recalculate, see get_cell()
+         */
+        void customize_cell(const calculator_type &calc, const size_t &cell) {
+            for (size_t slot = 0; slot < boundary_count; slot++) {
+                if (cells[boundary[slot]] != cell) {
+                    continue;
+                }
+                calc.run(boundary[slot], local, cell_view{*this, cell});
+                for (size_t i = 0; i < calc.get_node_count(); i++) {
+                    cell_distances[slot][i] = local.distance[i];
+                }
+            }
+        }
+
+        /**
+         * \brief Retrieve the cell a node is in.
+         *
+         * @param index Node index
+         * @return Cell index
+         */
+        size_t get_cell(const size_t &index) const {
+            return cells[index];
+        }
+
+        /**
+         * \brief Retrieve the number of boundary nodes.
+         *
+         * @return Number of boundary nodes
+         */
+        size_t get_boundary_count() const {
+            return boundary_count;
+        }
+
+        /**
+         * \brief Calculate the overlay distances from a source node.
+         *
+         * After this, get_distance() and get_next_hop() can be used for any destination.
+         * @param calc Calculator holding the network graph
+         * @param source_index Index of the node to start from
+         */
+        void query(const calculator_type &calc, const size_t &source_index = 0) {
+            calc.run(source_index, local, cell_view{*this, cells[source_index]});
+
+            for (size_t slot = 0; slot < boundary_count; slot++) {
+                overlay_known[slot] = false;
+                overlay_distances[slot] = local.distance[boundary[slot]];
+                first_hops[slot] = local.get_next_hop(boundary[slot]);
+            }
+
+            while (true) {
+                size_t current = no_node;
+                for (size_t slot = 0; slot < boundary_count; slot++) {
+                    if (!overlay_known[slot] && overlay_distances[slot] != calc.max_distance &&
+                        (current == no_node || algebra::better(overlay_distances[slot], overlay_distances[current]))) {
+                        current = slot;
+                    }
+                }
+                if (current == no_node) {
+                    return;
+                }
+                overlay_known[current] = true;
+                const size_t current_index = boundary[current];
+
+                // Shortcuts to the other boundary nodes of the same cell
+                for (size_t slot = 0; slot < boundary_count; slot++) {
+                    if (overlay_known[slot] || cells[boundary[slot]] != cells[current_index]) {
+                        continue;
+                    }
+                    const cost_type &shortcut = cell_distances[current][boundary[slot]];
+                    if (shortcut == calc.max_distance) {
+                        continue;
+                    }
+                    cost_type distance = algebra::combine(overlay_distances[current], shortcut);
+                    if (algebra::better(distance, overlay_distances[slot])) {
+                        overlay_distances[slot] = distance;
+                        first_hops[slot] = first_hops[current];
+                    }
+                }
+
+                // Edges leaving the cell
+                const node_type &current_node = calc.get_node(current_index);
+                for (size_t edge_id = 0; edge_id < current_node.edge_count; edge_id++) {
+                    size_t neighbour = calc.get_index_by_id(current_node.edges[edge_id]);
+                    if (neighbour == calc.get_node_count() || cells[neighbour] == cells[current_index] ||
+                        boundary_slots[neighbour] == no_node || overlay_known[boundary_slots[neighbour]]) {
+                        continue;
+                    }
+                    const size_t &slot = boundary_slots[neighbour];
+                    cost_type distance = algebra::combine(overlay_distances[current], current_node.edge_costs[edge_id]);
+                    if (algebra::better(distance, overlay_distances[slot])) {
+                        overlay_distances[slot] = distance;
+                        first_hops[slot] = current_index == source_index ? neighbour : first_hops[current];
+                    }
+                }
+            }
+        }
+
+        /**
+         * \brief Retrieve the distance to a node, after query().
+         *
+         * @param calc Calculator holding the network graph
+         * @param index Node index of the destination
+         * @return Distance from the query's source, or max_distance if unreachable
+         */
+        cost_type get_distance(const calculator_type &calc, const size_t &index) const {
+            return get_route(calc, index, nullptr);
+        }
+
+        /**
+         * \brief Retrieve the next hop to a node, after query().
+         *
+         * @param calc Calculator holding the network graph
+         * @param index Node index of the destination
+         * @return Node index of the next hop, or no_node if unreachable
+         */
+        size_t get_next_hop(const calculator_type &calc, const size_t &index) const {
+            size_t next_hop = no_node;
+            get_route(calc, index, &next_hop);
+            return next_hop;
+        }
+
+    private:
+        cost_type get_route(const calculator_type &calc, const size_t &index, size_t *next_hop) const {
+            cost_type best = calc.max_distance;
+            if (cells[index] == cells[local.source] && local.reachable(index)) {
+                best = local.distance[index];
+                if (next_hop != nullptr) {
+                    *next_hop = local.get_next_hop(index);
+                }
+            }
+
+            for (size_t slot = 0; slot < boundary_count; slot++) {
+                if (cells[boundary[slot]] != cells[index] || !overlay_known[slot] ||
+                    cell_distances[slot][index] == calc.max_distance) {
+                    continue;
+                }
+                cost_type distance = algebra::combine(overlay_distances[slot], cell_distances[slot][index]);
+                if (algebra::better(distance, best)) {
+                    best = distance;
+                    if (next_hop != nullptr) {
+                        *next_hop = boundary[slot] == local.source ? local.get_next_hop(index) : first_hops[slot];
+                    }
+                }
+            }
+            return best;
+        }
+    };
+
+    /**
+     * @}
+     */
+}
+
+#endif //IPASS_LINK_STATE_OVERLAY_HPP
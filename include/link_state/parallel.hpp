@@ -0,0 +1,66 @@
+/*
+ *
+ * Copyright Niels Post 2019.
+ * Distributed under the Boost Software License, Version 1.0.
+ * (See accompanying file LICENSE_1_0.txt or copy at
+ * https://www.boost.org/LICENSE_1_0.txt)
+ *
+*/
+
+#ifndef IPASS_LINK_STATE_PARALLEL_HPP
+#define IPASS_LINK_STATE_PARALLEL_HPP
+
+#include <thread>
+#include <vector>
+
+namespace link_state {
+
+    /**
+     * \addtogroup link_state
+     * @{
+     */
+
+    /**
+     * \brief Evaluate all nodes of a network in parallel, one thread per engine.
+     *
+     * Nodes are divided over the engines in contiguous ranges (sources for link_state::betweenness, destinations for link_state::link_load). Each engine keeps its own accumulators,
+     * so threads don't share any writable state. Afterwards all results are merged into the first engine.
+     * Engines should provide reset(), evaluate(calc, argument, first_node, last_node) and merge(other), like link_state::link_load.
+     *
+     * This header uses std::thread, so it should only be included on targets that support threads.
+     * The calculator isn't changed during evaluation, but it shouldn't be changed by other threads either.
+     * @param calc Calculator holding the network graph
+     * @param argument Argument passed to every evaluate() call (for example a demand matrix), has to be safe to use from multiple threads
+     * @param engines Array of engines, the combined result is stored in the first one
+     * @param engine_count Number of engines (and threads)
+     */
+    template<typename calculator_type, typename argument_type, typename engine_type>
+    void evaluate_parallel(const calculator_type &calc, const argument_type &argument, engine_type *engines,
+                           const size_t &engine_count) {
+        const size_t source_count = calc.get_node_count();
+        std::vector<std::thread> threads;
+        threads.reserve(engine_count);
+
+        for (size_t i = 0; i < engine_count; i++) {
+            size_t first_source = source_count * i / engine_count;
+            size_t last_source = source_count * (i + 1) / engine_count;
+            threads.emplace_back([&calc, &argument, engines, i, first_source, last_source]() {
+                engines[i].reset();
+                engines[i].evaluate(calc, argument, first_source, last_source);
+            });
+        }
+
+        for (size_t i = 0; i < engine_count; i++) {
+            threads[i].join();
+            if (i > 0) {
+                engines[0].merge(engines[i]);
+            }
+        }
+    }
+
+    /**
+     * @}
+     */
+}
+
+#endif //IPASS_LINK_STATE_PARALLEL_HPP
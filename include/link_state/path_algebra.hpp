@@ -0,0 +1,213 @@
+/*
+ *
+ * Copyright Niels Post 2019.
+ * Distributed under the Boost Software License, Version 1.0.
+ * (See accompanying file LICENSE_1_0.txt or copy at
+ * https://www.boost.org/LICENSE_1_0.txt)
+ *
+*/
+
+#ifndef IPASS_LINK_STATE_PATH_ALGEBRA_HPP
+#define IPASS_LINK_STATE_PATH_ALGEBRA_HPP
+
+#include <limits>
+#include <type_traits>
+
+namespace link_state {
+
+    /**
+     * \addtogroup link_state
+     * @{
+     */
+
+    /**
+     * \brief Path algebra for normal shortest paths: costs are added, and the lowest distance is best.
+     *
+     * A path algebra decides how the calculator combines distances and edge costs, and which distance is better.
+     * All functions are static and constexpr, so they are fully inlined into the calculator.
+     * Each algebra provides:
+     * - source(): distance of the source node to itself
+     * - unreachable(): distance of nodes that can't be reached
+     * - combine(distance, edge_cost): distance after following an edge
+     * - better(a, b): true if distance a is strictly better than distance b
+     * - additive: true if distances are sums of edge costs, which some algorithms (like link_state::disjoint_paths) rely on
+     * @tparam cost_type Datatype for edge costs and distances
+     */
+    template<typename cost_type>
+    struct shortest_path {
+        static constexpr bool additive = true;
+
+        static constexpr cost_type source() {
+            return 0;
+        }
+
+        static constexpr cost_type unreachable() {
+            return std::numeric_limits<cost_type>::has_infinity ? std::numeric_limits<cost_type>::infinity()
+                                                                 : std::numeric_limits<cost_type>::max();
+        }
+
+        static constexpr cost_type combine(const cost_type &distance, const cost_type &edge_cost) {
+            return distance + edge_cost;
+        }
+
+        static constexpr bool better(const cost_type &a, const cost_type &b) {
+            return a < b;
+        }
+    };
+
+    /**
+     * \brief Path algebra for shortest paths that saturates instead of overflowing.
+     *
+     * Sums that don't fit in cost_type become unreachable() instead of wrapping around, so cost_type only has to hold the largest useful distance,
+     * not every possible sum. A distance of exactly unreachable() is treated as unreachable as well.
+     * The addition is branchless, so the compiler can vectorise it.
+     * @tparam cost_type Unsigned integer datatype for edge costs and distances
+     */
+    template<typename cost_type>
+    struct saturating_shortest_path {
+        static_assert(std::is_integral<cost_type>::value && std::is_unsigned<cost_type>::value,
+                      "Saturating costs require an unsigned integer cost_type");
+
+        static constexpr bool additive = true;
+
+        static constexpr cost_type source() {
+            return 0;
+        }
+
+        static constexpr cost_type unreachable() {
+            return std::numeric_limits<cost_type>::max();
+        }
+
+        static constexpr cost_type combine(const cost_type &distance, const cost_type &edge_cost) {
+            const cost_type sum = static_cast<cost_type>(distance + edge_cost);
+            // All bits are set when the addition wrapped around
+            return static_cast<cost_type>(sum | static_cast<cost_type>(-static_cast<cost_type>(sum < distance)));
+        }
+
+        static constexpr bool better(const cost_type &a, const cost_type &b) {
+            return a < b;
+        }
+    };
+
+    /**
+     * \brief Path algebra for widest paths: a path is as wide as its narrowest edge, and the widest path is best.
+     *
+     * Edge costs are used as bandwidths. Nodes with a width of zero (or lower) are unreachable.
+     * @tparam cost_type Datatype for bandwidths
+     */
+    template<typename cost_type>
+    struct widest_path {
+        static constexpr bool additive = false;
+
+        static constexpr cost_type source() {
+            return std::numeric_limits<cost_type>::has_infinity ? std::numeric_limits<cost_type>::infinity()
+                                                                 : std::numeric_limits<cost_type>::max();
+        }
+
+        static constexpr cost_type unreachable() {
+            return std::numeric_limits<cost_type>::is_signed ? std::numeric_limits<cost_type>::lowest() : 0;
+        }
+
+        static constexpr cost_type combine(const cost_type &distance, const cost_type &edge_cost) {
+            return edge_cost < distance ? edge_cost : distance;
+        }
+
+        static constexpr bool better(const cost_type &a, const cost_type &b) {
+            return a > b;
+        }
+    };
+
+    /**
+     * \brief Path algebra for most reliable paths: edge reliabilities are multiplied, and the highest reliability is best.
+     *
+     * Edge costs are used as probabilities between 0 and 1, so cost_type should be a floating point type.
+     * @tparam cost_type Datatype for reliabilities
+     */
+    template<typename cost_type>
+    struct most_reliable {
+        static constexpr bool additive = false;
+
+        static constexpr cost_type source() {
+            return 1;
+        }
+
+        static constexpr cost_type unreachable() {
+            return 0;
+        }
+
+        static constexpr cost_type combine(const cost_type &distance, const cost_type &edge_cost) {
+            return distance * edge_cost;
+        }
+
+        static constexpr bool better(const cost_type &a, const cost_type &b) {
+            return a > b;
+        }
+    };
+
+    /**
+     * \brief Distance type for link_state::lexicographic, holding a summed cost and a hop count.
+     *
+     * Can be created from a plain cost, so it can be used as edge cost as well.
+     * @tparam cost_type Datatype for summed costs
+     * @tparam hop_type Datatype for hop counts
+     */
+    template<typename cost_type, typename hop_type = uint8_t>
+    struct lexicographic_cost {
+        /// Summed cost
+        cost_type cost;
+        /// Number of hops
+        hop_type hops;
+
+        /**
+         * \brief Create a lexicographic cost.
+         *
+         * @param cost Summed cost
+         * @param hops Number of hops
+         */
+        constexpr lexicographic_cost(const cost_type &cost = 0, const hop_type &hops = 0) : cost(cost), hops(hops) {}
+
+        constexpr bool operator==(const lexicographic_cost &rhs) const {
+            return cost == rhs.cost && hops == rhs.hops;
+        }
+
+        constexpr bool operator!=(const lexicographic_cost &rhs) const {
+            return !(*this == rhs);
+        }
+    };
+
+    /**
+     * \brief Path algebra comparing paths by cost first, and by hop count if costs are equal.
+     *
+     * Distances and edge costs are link_state::lexicographic_cost, the hop count of edge costs is ignored (every edge is one hop).
+     * @tparam cost_type Datatype for summed costs
+     * @tparam hop_type Datatype for hop counts
+     */
+    template<typename cost_type, typename hop_type = uint8_t>
+    struct lexicographic {
+        using value_type = lexicographic_cost<cost_type, hop_type>;
+
+        static constexpr bool additive = false;
+
+        static constexpr value_type source() {
+            return {0, 0};
+        }
+
+        static constexpr value_type unreachable() {
+            return {shortest_path<cost_type>::unreachable(), std::numeric_limits<hop_type>::max()};
+        }
+
+        static constexpr value_type combine(const value_type &distance, const value_type &edge_cost) {
+            return {static_cast<cost_type>(distance.cost + edge_cost.cost), static_cast<hop_type>(distance.hops + 1)};
+        }
+
+        static constexpr bool better(const value_type &a, const value_type &b) {
+            return a.cost < b.cost || (a.cost == b.cost && a.hops < b.hops);
+        }
+    };
+
+    /**
+     * @}
+     */
+}
+
+#endif //IPASS_LINK_STATE_PATH_ALGEBRA_HPP
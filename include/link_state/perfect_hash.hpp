@@ -0,0 +1,282 @@
+/*
+ *
+ * Copyright Niels Post 2019.
+ * Distributed under the Boost Software License, Version 1.0.
+ * (See accompanying file LICENSE_1_0.txt or copy at
+ * https://www.boost.org/LICENSE_1_0.txt)
+ *
+*/
+
+#ifndef IPASS_LINK_STATE_PERFECT_HASH_HPP
+#define IPASS_LINK_STATE_PERFECT_HASH_HPP
+
+#include <stdint.h>
+#include <array>
+#include <limits>
+
+namespace link_state {
+
+    /**
+     * \addtogroup link_state
+     * @{
+     */
+
+    /**
+     * \brief Node index using a minimal perfect hash over the node ids, for static or rarely changing topologies.
+     *
+     * Use as the calculator's id_index, and call calculator::rebuild_index() after a batch of updates.
+     * The hash is built CHD style: ids are grouped in buckets of about keys_per_bucket, and buckets are placed largest first,
+     * trying seeds until all ids of the bucket land in free slots. If a bucket finds no seed, the ids are grouped again with another
+     * bucket salt, up to max_attempts times. There are about 1% more slots than ids, so the last buckets still find room.
+     * Every lookup is a single probe. The source node isn't hashed, it stays at index 0.
+     *
+     * By default (move_nodes) the nodes are moved into slot order, so the slot of an id is its node index; ids landing in the extra slots
+     * are remapped to the slots left free. Storage is then one seed per bucket plus one remap entry per extra slot, without a slot table:
+     * with the defaults that's 16 / 5 + 0.16 = about 3.4 bits per node. Fewer bits need more ids per bucket or smaller seeds,
+     * and with 16 bit seeds the last buckets then often don't find room anymore.
+     * Moving the nodes changes node indices, so results indexed by node index should be recalculated, and it undoes calculator::reorder().
+     * Without move_nodes, the node order is kept (for example the locality order of calculator::reorder()) and every slot stores its node index,
+     * which adds one index_type per slot (16 bits per node with the defaults).
+     *
+     * Inserting a new id or removing a node invalidates the index, after which lookups fall back to a linear scan until the next rebuild.
+     * Replacing an existing node keeps the index valid.
+     * @tparam max_nodes Maximum number of nodes, should match the calculator's max_nodes
+     * @tparam seed_type Datatype for bucket seeds, limits the number of seeds tried per bucket
+     * @tparam keys_per_bucket Average number of ids per bucket, higher uses less memory but makes building slower and more likely to fail
+     * @tparam index_type Datatype for remap entries and slot indices, should be able to hold max_nodes - 1
+     * @tparam max_attempts Number of bucket salts tried before rebuild() gives up
+     * @tparam move_nodes Move the nodes into slot order, instead of storing a node index for every slot
+     */
+    template<size_t max_nodes, typename seed_type = uint16_t, size_t keys_per_bucket = 5, typename index_type = uint16_t,
+            size_t max_attempts = 8, bool move_nodes = true>
+    class perfect_hash_index {
+        static_assert(max_nodes - 1 <= std::numeric_limits<index_type>::max(), "index_type can't hold every node index");
+        static_assert(max_attempts > 0 && max_attempts <= 256, "Bucket salts are 8 bit");
+
+        static constexpr size_t max_buckets = (max_nodes + keys_per_bucket - 1) / keys_per_bucket;
+        static constexpr size_t max_extra_slots = max_nodes / 100 + 1;
+        static constexpr size_t max_slots = max_nodes + max_extra_slots;
+
+        std::array<seed_type, max_buckets> seeds = {};
+        std::array<index_type, move_nodes ? max_extra_slots : 0> remap = {};
+        std::array<index_type, move_nodes ? 0 : max_slots> slot_indices = {};
+        size_t key_count = 0;
+        size_t slot_count = 0;
+        size_t bucket_count = 0;
+        uint8_t bucket_salt = 0;
+        bool valid = false;
+
+        template<typename id_type>
+        static constexpr uint64_t hash(const id_type &id, const uint64_t &seed) {
+            uint64_t x = static_cast<uint64_t>(id) ^ (seed * 0x9E3779B97F4A7C15ull);
+            x ^= x >> 33;
+            x *= 0xFF51AFD7ED558CCDull;
+            x ^= x >> 33;
+            x *= 0xC4CEB9FE1A85EC53ull;
+            x ^= x >> 33;
+            return x;
+        }
+
+        template<typename id_type>
+        constexpr size_t bucket_of(const id_type &id) const {
+            // Inverted, so bucket salts never equal a slot seed
+            return hash(id, ~static_cast<uint64_t>(bucket_salt)) % bucket_count;
+        }
+
+        template<typename id_type>
+        constexpr size_t slot_of(const id_type &id, const seed_type &seed) const {
+            return hash(id, static_cast<uint64_t>(seed) + 1) % slot_count;
+        }
+
+        // Node index of an id, the source node at index 0 isn't part of the hash
+        template<typename id_type>
+        constexpr size_t index_of(const id_type &id) const {
+            size_t slot = slot_of(id, seeds[bucket_of(id)]);
+            if constexpr (move_nodes) {
+                return 1 + (slot < key_count ? slot : remap[slot - key_count]);
+            } else {
+                return slot_indices[slot];
+            }
+        }
+
+        template<typename node_array>
+        constexpr bool place(const node_array &nodes, const std::array<size_t, max_nodes> &members, const size_t &begin,
+                             const size_t &end, const size_t &bucket, std::array<bool, max_slots> &used) {
+            seed_type seed = 0;
+            do {
+                bool fits = true;
+                for (size_t i = begin; i < end && fits; i++) {
+                    size_t slot = slot_of(nodes[members[i]].id, seed);
+                    fits = !used[slot];
+                    for (size_t j = begin; j < i && fits; j++) {
+                        fits = slot != slot_of(nodes[members[j]].id, seed);
+                    }
+                }
+
+                if (fits) {
+                    for (size_t i = begin; i < end; i++) {
+                        used[slot_of(nodes[members[i]].id, seed)] = true;
+                    }
+                    seeds[bucket] = seed;
+                    return true;
+                }
+            } while (++seed != 0);
+            return false;
+        }
+
+        // Group the ids in buckets with the current bucket salt, and find a seed for every bucket
+        template<typename node_array>
+        constexpr bool place_all(const node_array &nodes, const size_t &node_count, std::array<bool, max_slots> &used) {
+            // Sort node indices by bucket (counting sort), bucket b holds members[bucket_start[b]] until members[bucket_start[b + 1]]
+            std::array<size_t, max_buckets + 1> bucket_start = {};
+            std::array<size_t, max_nodes> members = {};
+            for (size_t i = 1; i < node_count; i++) {
+                bucket_start[bucket_of(nodes[i].id) + 1]++;
+            }
+            size_t largest_bucket = 0;
+            for (size_t b = 0; b < bucket_count; b++) {
+                if (bucket_start[b + 1] > largest_bucket) {
+                    largest_bucket = bucket_start[b + 1];
+                }
+                bucket_start[b + 1] += bucket_start[b];
+            }
+            std::array<size_t, max_buckets> filled = {};
+            for (size_t i = 1; i < node_count; i++) {
+                size_t bucket = bucket_of(nodes[i].id);
+                members[bucket_start[bucket] + filled[bucket]++] = i;
+            }
+
+            // Place the largest buckets first, while most slots are still free
+            for (size_t size = largest_bucket; size > 0; size--) {
+                for (size_t b = 0; b < bucket_count; b++) {
+                    if (bucket_start[b + 1] - bucket_start[b] == size &&
+                        !place(nodes, members, bucket_start[b], bucket_start[b + 1], b, used)) {
+                        return false;
+                    }
+                }
+            }
+            return true;
+        }
+
+    public:
+        /**
+         * \brief Find the index of the node with a given id.
+         *
+         * @param nodes The calculator's nodes
+         * @param node_count Current number of nodes
+         * @param id Identifier to check for
+         * @return The index of the node, or node_count if no node with that id exists
+         */
+        template<typename node_array, typename id_type>
+        constexpr size_t find(const node_array &nodes, const size_t &node_count, const id_type &id) const {
+            if (!valid || node_count != key_count + 1) {
+                for (size_t i = 0; i < node_count; i++) {
+                    if (nodes[i].id == id) {
+                        return i;
+                    }
+                }
+                return node_count;
+            }
+
+            size_t index = index_of(id);
+            if (nodes[index].id == id) {
+                return index;
+            }
+            return nodes[0].id == id ? 0 : node_count;
+        }
+
+        /**
+         * \brief Mark the index as outdated, so lookups fall back to a linear scan.
+         */
+        constexpr void invalidate() {
+            valid = false;
+        }
+
+        /**
+         * \brief Build the perfect hash for the current nodes, and move the nodes into slot order if move_nodes is set.
+         *
+         * Node ids should be unique. Nodes are only moved if the hash was found.
+         * Building fails for a few id sets with any one bucket salt, so up to max_attempts salts are tried.
+         * @param nodes The calculator's nodes
+         * @param node_count Current number of nodes
+         * @return False if no perfect hash was found, lookups then keep using a linear scan
+         */
+        template<typename node_array>
+        constexpr bool rebuild(node_array &nodes, const size_t &node_count) {
+            valid = false;
+            if (node_count < 2) {
+                return false;
+            }
+            key_count = node_count - 1;
+            slot_count = key_count + key_count / 100 + 1;
+            bucket_count = (key_count + keys_per_bucket - 1) / keys_per_bucket;
+
+            std::array<bool, max_slots> used = {};
+            bucket_salt = 0;
+            while (!place_all(nodes, node_count, used)) {
+                if (++bucket_salt == max_attempts) {
+                    return false;
+                }
+                for (size_t slot = 0; slot < slot_count; slot++) {
+                    used[slot] = false;
+                }
+            }
+
+            if constexpr (move_nodes) {
+                // Extra slots in use are remapped to the free slots below key_count, there are exactly as many of those
+                size_t free_slot = 0;
+                for (size_t slot = key_count; slot < slot_count; slot++) {
+                    if (used[slot]) {
+                        while (used[free_slot]) {
+                            free_slot++;
+                        }
+                        remap[slot - key_count] = static_cast<index_type>(free_slot++);
+                    }
+                }
+
+                // Every swap puts one node at its final index
+                for (size_t i = 1; i < node_count; i++) {
+                    size_t target = index_of(nodes[i].id);
+                    while (target != i) {
+                        auto moved = nodes[target];
+                        nodes[target] = nodes[i];
+                        nodes[i] = moved;
+                        target = index_of(nodes[i].id);
+                    }
+                }
+            } else {
+                for (size_t i = 1; i < node_count; i++) {
+                    slot_indices[slot_of(nodes[i].id, seeds[bucket_of(nodes[i].id)])] = static_cast<index_type>(i);
+                }
+            }
+
+            valid = true;
+            return true;
+        }
+
+        /**
+         * \brief Check if lookups are currently single probe, part of the node index interface (see link_state::linear_index).
+         *
+         * @param node_count Current number of nodes
+         * @return True if the index is valid for this number of nodes
+         */
+        constexpr bool is_constant_time(const size_t &node_count) const {
+            return valid && node_count == key_count + 1;
+        }
+
+        /**
+         * \brief Check if the index is up to date, and lookups are single probe.
+         *
+         * @return True if the index was built and not invalidated since
+         */
+        constexpr bool is_valid() const {
+            return valid;
+        }
+    };
+
+    /**
+     * @}
+     */
+}
+
+#endif //IPASS_LINK_STATE_PERFECT_HASH_HPP
@@ -0,0 +1,168 @@
+/*
+ *
+ * Copyright Niels Post 2019.
+ * Distributed under the Boost Software License, Version 1.0.
+ * (See accompanying file LICENSE_1_0.txt or copy at
+ * https://www.boost.org/LICENSE_1_0.txt)
+ *
+*/
+
+#ifndef IPASS_LINK_STATE_RESILIENCE_HPP
+#define IPASS_LINK_STATE_RESILIENCE_HPP
+
+#include <link_state/calculator.hpp>
+
+namespace link_state {
+
+    /**
+     * \addtogroup link_state
+     * @{
+     */
+
+    /**
+     * \brief Finds single points of failure: articulation points (nodes) and bridges (links) whose failure disconnects the network.
+     *
+     * Uses Tarjan's linear time depth first search. The search is iterative, it returns to the parent through the parent index instead of recursing,
+     * so stack usage doesn't depend on the size of the network.
+     * The scratch arrays of a calculator::state_type are reused for discovery order and parents, so apart from the results
+     * only two arrays per node are needed (edge cursors and low links). That state doesn't hold shortest paths after analyse().
+     *
+     * Links are assumed to be bidirectional, and parallel links between the same two nodes are treated as a single link.
+     * @tparam calculator_type Calculator type holding the network graph
+     */
+    template<typename calculator_type>
+    class resilience_analysis {
+    public:
+        using node_type = typename calculator_type::node_type;
+        using state_type = typename calculator_type::state_type;
+
+        /**
+         * \brief A link whose failure disconnects the network, as node indices.
+         */
+        struct bridge {
+            /// Node closest to the start of the search
+            size_t from;
+            /// Node on the other side of the link
+            size_t to;
+        };
+
+    private:
+        std::array<size_t, calculator_type::node_capacity> edge_cursor = {};
+        std::array<size_t, calculator_type::node_capacity> low = {};
+        std::array<bool, calculator_type::node_capacity> articulation = {};
+        std::array<bridge, calculator_type::node_capacity> bridges = {};
+        size_t bridge_count = 0;
+
+    public:
+        /**
+         * \brief Find all articulation points and bridges in the network.
+         *
+         * All components are searched, not only the one holding the source node.
+         * @param calc Calculator holding the network graph
+         * @param state Scratch state, its contents are overwritten
+         */
+        void analyse(const calculator_type &calc, state_type &state) {
+            const size_t node_count = calc.get_node_count();
+            std::array<size_t, calculator_type::node_capacity> &discovery = state.order;
+            std::array<size_t, calculator_type::node_capacity> &parent = state.previous;
+            std::array<bool, calculator_type::node_capacity> &visited = state.shortest_path_known;
+
+            for (size_t i = 0; i < node_count; i++) {
+                visited[i] = false;
+                articulation[i] = false;
+            }
+            bridge_count = 0;
+            size_t time = 0;
+
+            for (size_t root = 0; root < node_count; root++) {
+                if (visited[root]) {
+                    continue;
+                }
+                visited[root] = true;
+                discovery[root] = low[root] = time++;
+                parent[root] = root;
+                edge_cursor[root] = 0;
+                size_t root_children = 0;
+
+                size_t current = root;
+                while (true) {
+                    const node_type &current_node = calc.get_node(current);
+                    if (edge_cursor[current] < current_node.edge_count) {
+                        size_t neighbour = calc.get_index_by_id(current_node.edges[edge_cursor[current]++]);
+                        if (neighbour == node_count || neighbour == parent[current]) {
+                            continue;
+                        }
+
+                        if (visited[neighbour]) {
+                            if (discovery[neighbour] < low[current]) {
+                                low[current] = discovery[neighbour];
+                            }
+                        } else {
+                            visited[neighbour] = true;
+                            discovery[neighbour] = low[neighbour] = time++;
+                            parent[neighbour] = current;
+                            edge_cursor[neighbour] = 0;
+                            if (current == root) {
+                                root_children++;
+                            }
+                            current = neighbour;
+                        }
+                        continue;
+                    }
+
+                    // All edges of current are done, return to its parent
+                    if (current == root) {
+                        articulation[root] = root_children > 1;
+                        break;
+                    }
+                    size_t up = parent[current];
+                    if (low[current] < low[up]) {
+                        low[up] = low[current];
+                    }
+                    if (up != root && low[current] >= discovery[up]) {
+                        articulation[up] = true;
+                    }
+                    if (low[current] > discovery[up]) {
+                        bridges[bridge_count++] = {up, current};
+                    }
+                    current = up;
+                }
+            }
+        }
+
+        /**
+         * \brief Check if a node is an articulation point, found in the last analysis.
+         *
+         * @param index Node index
+         * @return True if removing the node disconnects the network
+         */
+        bool is_articulation_point(const size_t &index) const {
+            return articulation[index];
+        }
+
+        /**
+         * \brief Retrieve the number of bridges found in the last analysis.
+         *
+         * @return Number of bridges
+         */
+        size_t get_bridge_count() const {
+            return bridge_count;
+        }
+
+        /**
+         * \brief Retrieve a bridge found in the last analysis.
+         *
+         * @param index Bridge index (below get_bridge_count())
+         * @return The bridge
+         */
+        const bridge &get_bridge(const size_t &index) const {
+            return bridges[index];
+        }
+    };
+
+    /**
+     * @}
+     */
+}
+
+#endif //IPASS_LINK_STATE_RESILIENCE_HPP
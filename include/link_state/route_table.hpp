@@ -0,0 +1,145 @@
+/*
+ *
+ * Copyright Niels Post 2019.
+ * Distributed under the Boost Software License, Version 1.0.
+ * (See accompanying file LICENSE_1_0.txt or copy at
+ * https://www.boost.org/LICENSE_1_0.txt)
+ *
+*/
+
+#ifndef IPASS_LINK_STATE_ROUTE_TABLE_HPP
+#define IPASS_LINK_STATE_ROUTE_TABLE_HPP
+
+#include <stdint.h>
+#include <array>
+#include <limits>
+
+namespace link_state {
+
+    /**
+     * \addtogroup link_state
+     * @{
+     */
+
+    /**
+     * \brief Compact, read-only routing table compiled from a calculator.
+     *
+     * After routing is calculated, only next hops are needed, not the full network graph.
+     * The table stores the reachable destination ids sorted, with a small index into a list of distinct next hops for each destination.
+     * Lookups are a binary search. Everything is constexpr, so a table compiled from a constexpr calculator can be placed in flash:
+     *
+     *     constexpr auto table = link_state::route_table<uint8_t, 16>::compile(calc);
+     *
+     * @tparam id_type Datatype for node identifiers, should match the calculator's id_type
+     * @tparam max_entries Maximum number of destinations
+     * @tparam max_next_hops Maximum number of distinct next hops (usually the number of direct neighbours)
+     * @tparam index_type Datatype for next hop indices, should be able to hold max_next_hops
+     */
+    template<typename id_type, size_t max_entries, size_t max_next_hops = max_entries, typename index_type = uint8_t>
+    class route_table {
+        static_assert(max_next_hops <= std::numeric_limits<index_type>::max(), "index_type can't hold every next hop index");
+
+        std::array<id_type, max_entries> ids = {};
+        std::array<index_type, max_entries> next_hop_indices = {};
+        std::array<id_type, max_next_hops> next_hops = {};
+        size_t entry_count = 0;
+        size_t next_hop_count = 0;
+        bool complete = true;
+
+        constexpr bool add(const id_type &id, const id_type &next_hop) {
+            size_t next_hop_index = 0;
+            while (next_hop_index < next_hop_count && next_hops[next_hop_index] != next_hop) {
+                next_hop_index++;
+            }
+            if (next_hop_index == next_hop_count) {
+                if (next_hop_count == max_next_hops) {
+                    return false;
+                }
+                next_hops[next_hop_count++] = next_hop;
+            }
+            if (entry_count == max_entries) {
+                return false;
+            }
+
+            // Insertion sort, keeping ids ordered for binary search
+            size_t position = entry_count++;
+            while (position > 0 && id < ids[position - 1]) {
+                ids[position] = ids[position - 1];
+                next_hop_indices[position] = next_hop_indices[position - 1];
+                position--;
+            }
+            ids[position] = id;
+            next_hop_indices[position] = static_cast<index_type>(next_hop_index);
+            return true;
+        }
+
+    public:
+        /**
+         * \brief Compile the routing table of a calculator.
+         *
+         * setup() and loop() should have been called on the calculator in the current network state.
+         * Unreachable nodes are left out. If the table is too small, is_complete() will return false.
+         * @param calc Calculator to compile the routing table of
+         * @return The compiled table
+         */
+        template<typename calculator_type>
+        static constexpr route_table compile(const calculator_type &calc) {
+            route_table table;
+            for (size_t i = 1; i < calc.get_node_count(); i++) {
+                const id_type &id = calc.get_node(i).id;
+                id_type next_hop = calc.get_next_hop(id);
+                if (next_hop != 0 && !table.add(id, next_hop)) {
+                    table.complete = false;
+                }
+            }
+            return table;
+        }
+
+        /**
+         * \brief Get next hop for a given node id, like calculator::get_next_hop().
+         *
+         * @param id ID to find next hop for
+         * @return The id of the next hop, or 0 if the node is unknown or unreachable
+         */
+        constexpr id_type get_next_hop(const id_type &id) const {
+            size_t low = 0;
+            size_t high = entry_count;
+            while (low < high) {
+                size_t middle = low + (high - low) / 2;
+                if (ids[middle] < id) {
+                    low = middle + 1;
+                } else {
+                    high = middle;
+                }
+            }
+            if (low == entry_count || ids[low] != id) {
+                return 0;
+            }
+            return next_hops[next_hop_indices[low]];
+        }
+
+        /**
+         * \brief Retrieve the number of destinations in the table.
+         *
+         * @return Number of destinations
+         */
+        constexpr size_t get_entry_count() const {
+            return entry_count;
+        }
+
+        /**
+         * \brief Check if all reachable destinations fitted in the table.
+         *
+         * @return False if max_entries or max_next_hops was too small
+         */
+        constexpr bool is_complete() const {
+            return complete;
+        }
+    };
+
+    /**
+     * @}
+     */
+}
+
+#endif //IPASS_LINK_STATE_ROUTE_TABLE_HPP
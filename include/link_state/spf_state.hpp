@@ -0,0 +1,132 @@
+/*
+ *
+ * Copyright Niels Post 2019.
+ * Distributed under the Boost Software License, Version 1.0.
+ * (See accompanying file LICENSE_1_0.txt or copy at
+ * https://www.boost.org/LICENSE_1_0.txt)
+ *
+*/
+
+#ifndef IPASS_LINK_STATE_SPF_STATE_HPP
+#define IPASS_LINK_STATE_SPF_STATE_HPP
+
+#include <stdint.h>
+#include <array>
+#include <limits>
+
+namespace link_state {
+
+    /**
+     * \addtogroup link_state
+     * @{
+     */
+
+    /**
+     * \brief Hop counts of a shortest path run, used to break ties between equal cost paths.
+     *
+     * @tparam hop_type Datatype for hop counts, or void to store no hop counts at all
+     * @tparam max_nodes Maximum number of nodes
+     */
+    template<typename hop_type, size_t max_nodes>
+    struct spf_hops {
+        static_assert(max_nodes - 1 <= std::numeric_limits<hop_type>::max(), "hop_type can't hold the longest possible path");
+
+        /// Number of hops in the shortest path to each node
+        std::array<hop_type, max_nodes> hops = {};
+    };
+
+    /**
+     * \brief Empty hop counts, for calculators that don't break ties on hop count.
+     */
+    template<size_t max_nodes>
+    struct spf_hops<void, max_nodes> {
+    };
+
+    /**
+     * \brief Result storage for a shortest path run that doesn't write into the calculator's nodes.
+     *
+     * Used by calculator::run(), so queries (constrained paths, alternative paths, runs from other sources) can be done
+     * without overwriting the routing information in the nodes.
+     * All arrays are indexed by node index, so the state is only valid as long as the calculator's nodes aren't changed.
+     * @tparam cost_type Datatype for distances, should match the calculator's cost_type
+     * @tparam max_nodes Maximum number of nodes, should match the calculator's max_nodes
+     * @tparam hop_type Datatype for hop counts, should match the calculator's hop_type
+     */
+    template<typename cost_type, size_t max_nodes, typename hop_type = void>
+    struct spf_state : public spf_hops<hop_type, max_nodes> {
+        /// Index used in spf_state::previous for nodes that don't have a previous node (yet)
+        static constexpr size_t no_node = max_nodes;
+
+        /// Index of the node the run was started from
+        size_t source = 0;
+        /// Distance from the source node to each node
+        std::array<cost_type, max_nodes> distance = {};
+        /// Index of the previous node in the shortest path to each node. The source node points to itself
+        std::array<size_t, max_nodes> previous = {};
+        /// Is the distance of each node final
+        std::array<bool, max_nodes> shortest_path_known = {};
+        /// Indices of all known nodes, in the order they became known (increasing distance)
+        std::array<size_t, max_nodes> order = {};
+        /// Number of known nodes in spf_state::order
+        size_t known_count = 0;
+
+        /**
+         * \brief Check if a path to a node was found
+         *
+         * @param index Node index
+         * @return True if the node was reached in the last run
+         */
+        constexpr bool reachable(const size_t &index) const {
+            return shortest_path_known[index];
+        }
+
+        /**
+         * \brief Retrieve the first node after the source on the path to a node.
+         *
+         * @param index Node index of the destination
+         * @return Node index of the next hop, or no_node if the node isn't reachable or is the source itself
+         */
+        constexpr size_t get_next_hop(size_t index) const {
+            if (!reachable(index) || index == source) {
+                return no_node;
+            }
+            while (previous[index] != source) {
+                index = previous[index];
+            }
+            return index;
+        }
+
+        /**
+         * \brief Retrieve the path to a node as a list of node indices.
+         *
+         * The path is written source first, destination last.
+         * @param index Node index of the destination
+         * @param path Array to write the path into
+         * @return Number of nodes in the path (including source and destination), or 0 if the node isn't reachable
+         */
+        constexpr size_t get_path(size_t index, std::array<size_t, max_nodes> &path) const {
+            if (!reachable(index)) {
+                return 0;
+            }
+
+            size_t length = 0;
+            for (size_t current = index; current != source; current = previous[current]) {
+                path[length++] = current;
+            }
+            path[length++] = source;
+
+            for (size_t i = 0; i < length / 2; i++) {
+                size_t temp = path[i];
+                path[i] = path[length - 1 - i];
+                path[length - 1 - i] = temp;
+            }
+            return length;
+        }
+    };
+
+    /**
+     * @}
+     */
+}
+
+#endif //IPASS_LINK_STATE_SPF_STATE_HPP
@@ -0,0 +1,102 @@
+/*
+ *
+ * Copyright Niels Post 2019.
+ * Distributed under the Boost Software License, Version 1.0.
+ * (See accompanying file LICENSE_1_0.txt or copy at
+ * https://www.boost.org/LICENSE_1_0.txt)
+ *
+*/
+
+#ifndef IPASS_LINK_STATE_SPT_COUNTS_HPP
+#define IPASS_LINK_STATE_SPT_COUNTS_HPP
+
+#include <link_state/calculator.hpp>
+
+namespace link_state {
+
+    /**
+     * \addtogroup link_state
+     * @{
+     */
+
+    /**
+     * \brief Number of equal cost shortest paths from the source of a run to every node.
+     *
+     * The edges on any shortest path (the shortest path DAG) are the edges whose cost added to the distance of their start
+     * gives the distance of their end. Walking the nodes in the order they became known, each node adds its path count to
+     * the ends of its DAG edges, so counting is O(N + E) on top of the run.
+     * Used by link_state::betweenness, which gives every shortest path between two nodes an equal share.
+     * Edge costs should be positive, zero cost edges can make equal cost paths be counted incorrectly.
+     * @tparam calculator_type Calculator type holding the network graph
+     * @tparam count_type Datatype for path counts, should be able to hold fractions if the counts are used for splitting
+     */
+    template<typename calculator_type, typename count_type = double>
+    class spt_counts {
+    public:
+        using node_type = typename calculator_type::node_type;
+        using state_type = typename calculator_type::state_type;
+
+    private:
+        std::array<count_type, calculator_type::node_capacity> path_count = {};
+
+    public:
+        /**
+         * \brief Call a function for each edge of a node that is part of the shortest path DAG of a run.
+         *
+         * The function is called as function(edge_index, to_index).
+         * @param calc Calculator holding the network graph
+         * @param state State of the run
+         * @param from_index Index of the node the edges start at
+         * @param function Function to call
+         */
+        template<typename function_type>
+        static void for_each_dag_edge(const calculator_type &calc, const state_type &state, const size_t &from_index,
+                                      const function_type &function) {
+            const node_type &from = calc.get_node(from_index);
+            for (size_t edge_id = 0; edge_id < from.edge_count; edge_id++) {
+                size_t to_index = calc.get_index_by_id(from.edges[edge_id]);
+                if (to_index != calc.get_node_count() && state.reachable(to_index) && to_index != state.source &&
+                    calculator_type::algebra_type::combine(state.distance[from_index], from.edge_costs[edge_id]) ==
+                    state.distance[to_index]) {
+                    function(edge_id, to_index);
+                }
+            }
+        }
+
+        /**
+         * \brief Count the shortest paths from the source of a run to every node it reached.
+         *
+         * @param calc Calculator holding the network graph
+         * @param state State of the run
+         */
+        void count(const calculator_type &calc, const state_type &state) {
+            for (size_t i = 0; i < calc.get_node_count(); i++) {
+                path_count[i] = 0;
+            }
+            path_count[state.source] = 1;
+
+            for (size_t position = 0; position < state.known_count; position++) {
+                const size_t from_index = state.order[position];
+                for_each_dag_edge(calc, state, from_index, [this, &from_index](const size_t &, const size_t &to_index) {
+                    path_count[to_index] += path_count[from_index];
+                });
+            }
+        }
+
+        /**
+         * \brief Retrieve the number of shortest paths to a node, found by the last count().
+         *
+         * @param index Node index
+         * @return Number of shortest paths, 0 if the node wasn't reached
+         */
+        const count_type &get_path_count(const size_t &index) const {
+            return path_count[index];
+        }
+    };
+
+    /**
+     * @}
+     */
+}
+
+#endif //IPASS_LINK_STATE_SPT_COUNTS_HPP